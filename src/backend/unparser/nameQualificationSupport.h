@@ -72,12 +72,12 @@ class NameQualificationTraversal : public AstTopDownBottomUpProcessing<NameQuali
        // to the static data members in SgNode, but this does not permit the proper handling of nexted types in 
        // templates since the unparser uses the SgNode static members directly.  so the switch to make this a 
        // reference fixes this problem.
-          std::map<SgNode*,std::string> & qualifiedNameMapForNames;
-          std::map<SgNode*,std::string> & qualifiedNameMapForTypes;
+          SgNodeStringMap & qualifiedNameMapForNames;
+          SgNodeStringMap & qualifiedNameMapForTypes;
 
        // DQ (6/3/2011): This is to save the names of types where they can be named differently when referenced 
        // from different locations in the source code.
-          std::map<SgNode*,std::string> & typeNameMap;
+          SgNodeStringMap & typeNameMap;
 
        // DQ (7/22/2011): Alternatively we should treat array types just like templated types that can
        // contain subtypes that require arbitrarily complex name qualification for their different parts.
@@ -105,7 +105,7 @@ class NameQualificationTraversal : public AstTopDownBottomUpProcessing<NameQuali
      public:
        // HiddenListTraversal();
        // HiddenListTraversal(SgNode* root);
-          NameQualificationTraversal(std::map<SgNode*,std::string> & input_qualifiedNameMapForNames, std::map<SgNode*,std::string> & input_qualifiedNameMapForTypes, std::map<SgNode*,std::string> & input_typeNameMap, std::set<SgNode*> & input_referencedNameSet);
+          NameQualificationTraversal(SgNodeStringMap & input_qualifiedNameMapForNames, SgNodeStringMap & input_qualifiedNameMapForTypes, SgNodeStringMap & input_typeNameMap, std::set<SgNode*> & input_referencedNameSet);
 
        // DQ (7/23/2011): This permits recursive calls to the traversal AND specification of the current scope
        // used to support name qualification on expressions where we can't backout the current scope.  Used 
@@ -197,8 +197,8 @@ class NameQualificationTraversal : public AstTopDownBottomUpProcessing<NameQuali
           void evaluateNameQualificationForTemplateArgumentList ( SgTemplateArgumentPtrList & templateArgumentList, SgScopeStatement* currentScope, SgStatement* positionStatement );
 
        // DQ (5/28/2011): Added support to set the global qualified name map.
-          const std::map<SgNode*,std::string> & get_qualifiedNameMapForNames() const;
-          const std::map<SgNode*,std::string> & get_qualifiedNameMapForTypes() const;
+          const SgNodeStringMap & get_qualifiedNameMapForNames() const;
+          const SgNodeStringMap & get_qualifiedNameMapForTypes() const;
 
        // DQ (6/3/2011): Evaluate types to permit the strings representing unparsing the types 
        // are saved in a separate map associated with the IR node referencing the type.  This 
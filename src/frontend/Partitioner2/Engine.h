@@ -8,8 +8,14 @@
 #include <Partitioner2/Partitioner.h>
 #include <Partitioner2/Utility.h>
 #include <sawyer/DistinctList.h>
+#include <boost/shared_ptr.hpp>
 
 namespace rose {
+
+namespace WorkStealing {
+class Pool;
+}
+
 namespace BinaryAnalysis {
 namespace Partitioner2 {
 
@@ -71,11 +77,23 @@ class Engine {
     bool intraFunctionCodeSearch_;                      // search for unreachable code surrounded by a function?
     bool opaquePredicateSearch_;                        // search for code opposite opaque predicate edges?
     bool postPartitionAnalyses_;                        // run various analyses after partitioning?
+    size_t nThreads_;                                   // number of threads for speculative disassembly; zero means all
+    // Holds the engine's thread pool.  A copy of an engine starts without a pool and creates its own when needed, so that
+    // engines never share worker threads.
+    struct ThreadPoolHolder {
+        boost::shared_ptr<WorkStealing::Pool> pool;
+        ThreadPoolHolder() {}
+        ThreadPoolHolder(const ThreadPoolHolder&) {}
+        ThreadPoolHolder& operator=(const ThreadPoolHolder&) { pool.reset(); return *this; }
+    };
+
+    ThreadPoolHolder threadPool_;                       // created on first use and reused; reset when nThreads_ changes
+    std::string instructionCacheName_;                  // name of persistent instruction cache file, or empty
 public:
     Engine()
         : interp_(NULL), loader_(NULL), disassembler_(), basicBlockWorkList_(BasicBlockWorkList::instance()),
           dataMentionedFunctionSearch_(false), intraFunctionCodeSearch_(true), opaquePredicateSearch_(true),
-          postPartitionAnalyses_(true) {}
+          postPartitionAnalyses_(true), nThreads_(1) {}
 
     virtual ~Engine() {}
 
@@ -252,6 +270,29 @@ public:
     bool postPartitionAnalyses() const /*final*/ { return postPartitionAnalyses_; }
     virtual void postPartitionAnalyses(bool b) { postPartitionAnalyses_ = b; }
     /** @} */
+
+    /** Property: number of threads for basic block discovery.
+     *
+     *  When greater than one, @ref discoverBasicBlocks disassembles instructions for pending basic blocks speculatively on
+     *  this many threads (see @ref speculateBasicBlockInstructions) while the insertion of blocks into the CFG/AUM remains
+     *  serial and in the same order as a single-threaded engine, so the partitioning results are identical regardless of this
+     *  setting.  A value of zero means use as many threads as there is hardware concurrency.  The default is one.
+     *
+     * @{ */
+    size_t nThreads() const /*final*/ { return nThreads_; }
+    virtual void nThreads(size_t n) { nThreads_ = n; threadPool_.pool.reset(); }
+    /** @} */
+
+    /** Property: persistent instruction cache file.
+     *
+     *  If non-empty, then @ref createBarePartitioner opens (or creates) this file as an @ref InstructionCache and gives it to
+     *  the partitioner's instruction provider so that decoding results are shared across runs and across specimens.  The
+     *  default is empty, meaning no persistent cache.
+     *
+     * @{ */
+    const std::string& instructionCacheName() const /*final*/ { return instructionCacheName_; }
+    virtual void instructionCacheName(const std::string &s) { instructionCacheName_ = s; }
+    /** @} */
     
     /** Property: interpretation.
      *
@@ -328,7 +369,10 @@ public:
      *  Processes the "undiscovered" work list until the list becomes empty.  This list is the list of basic block placeholders
      *  for which no attempt has been made to discover instructions.  This method implements a recursive descent disassembler,
      *  although it does not process the control flow edges in any particular order. Subclasses are expected to override this
-     *  to implement a more directed approach to discovering basic blocks. */
+     *  to implement a more directed approach to discovering basic blocks.
+     *
+     *  If the @ref nThreads property is not one, then instructions for the blocks at the top of the work list are first
+     *  disassembled in parallel by @ref speculateBasicBlockInstructions. */
     virtual void discoverBasicBlocks(Partitioner&);
 
     /** Discover as many functions as possible.
@@ -394,6 +438,30 @@ public:
      *  condition for a false return is that the pendingCallReturn list is empty. */
     virtual bool makeNextCallReturnEdge(Partitioner&, boost::logic::tribool assumeCallReturns);
 
+    /** Disassemble instructions for pending basic blocks in parallel.
+     *
+     *  If the next address on the "undiscovered" work list has no cached instruction, then a batch of addresses is taken from
+     *  the top of that work list and each address's fall-through path is disassembled on a work-stealing thread pool, stopping
+     *  at the first instruction that naively terminates a basic block.  Each thread uses its own clone of the disassembler and
+     *  its own copy of the bytes, and the resulting instructions are then inserted serially into the partitioner's instruction
+     *  provider.  No basic blocks are created and the CFG/AUM is not modified; the subsequent serial calls to @ref
+     *  makeNextBasicBlock simply find their instructions already cached.  Since disassembly of an address is independent of the
+     *  partitioner state, the final partitioning results are the same as if this method had never been called.
+     *
+     *  If the instruction provider has a persistent @ref InstructionCache then it is consulted serially before the threads
+     *  start, the threads disassemble only what it lacks, and their results are recorded in it when they're committed.
+     *
+     *  Returns the number of instructions that were added to the instruction provider's cache. This method does nothing when
+     *  the @ref nThreads property is one or the instruction provider's disassembler is disabled. */
+    virtual size_t speculateBasicBlockInstructions(Partitioner&);
+
+    /** Thread pool for parallel steps.
+     *
+     *  Returns a pool with @ref nThreads threads. The pool is created the first time it's needed and reused by later calls so
+     *  that its threads are started only once per engine.  Changing the @ref nThreads property discards the pool, and a copy of
+     *  an engine creates its own pool instead of sharing this one. */
+    WorkStealing::Pool& threadPool();
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     //                                  Methods to make functions.
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
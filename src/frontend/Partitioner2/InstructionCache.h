@@ -0,0 +1,138 @@
+#ifndef ROSE_BinaryAnalysis_Partitioner2_InstructionCache_H
+#define ROSE_BinaryAnalysis_Partitioner2_InstructionCache_H
+
+#include "Disassembler.h"
+
+#include <boost/cstdint.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <sawyer/SharedPointer.h>
+#include <string>
+
+namespace rose {
+namespace BinaryAnalysis {
+
+/** Persistent, content-addressed cache of disassembled instructions.
+ *
+ *  An instruction cache is a memory-mapped file that remembers, for each (architecture, virtual address, instruction bytes)
+ *  triple, the instruction that the disassembler produced for those bytes.  Since the key includes a hash of the bytes rather
+ *  than the name of the specimen, the same cache file can be shared by many specimens that map the same libraries at the same
+ *  addresses, and it remains correct when a specimen changes: changed bytes simply hash to a different key.
+ *
+ *  The cache is consulted by an @ref InstructionProvider that has one (see @ref InstructionProvider::diskCache).  A hit
+ *  rebuilds the instruction AST from the record without calling the disassembler.  Each record holds a compact encoding of
+ *  one instruction: its fields, the tree of operand expressions, and the types of the expressions as indexes into a table of
+ *  the types the disassemblers build.  Only x86 instructions (valid or "unknown") whose nodes can all be encoded and whose
+ *  encoding fits in a record are cached; other instructions are simply disassembled every time.  An instruction rebuilt from
+ *  the cache is identical to the one the disassembler would return.
+ *
+ *  The file is a fixed-size, open-addressing hash table of 128-byte records preceded by a small header that includes a magic
+ *  number and a version.  It's a cache, not a database: when a probe sequence is full the record at the home slot is
+ *  overwritten regardless of its age, and a cache file written with a different format version is reinitialized.  A file that is not an instruction
+ *  cache (one that doesn't start with the magic number) is never modified.  Each record stores a second, independent hash of
+ *  its key mixed with its contents, so a record that was torn by a concurrent writer in another process is detected and
+ *  treated as a miss.
+ *
+ *  Thread safety: Not thread safe. */
+class InstructionCache: public Sawyer::SharedObject {
+public:
+    /** Reference counting pointer to an instruction cache. */
+    typedef Sawyer::SharedPointer<InstructionCache> Ptr;
+
+    /** Number of bytes per address that are part of the key.
+     *
+     *  This must be at least as large as the longest instruction of any architecture since decoding an instruction may
+     *  examine all of its bytes. */
+    static const size_t keySize = 32;
+
+    /** Default number of records in a new cache file. */
+    static const size_t defaultCapacity = 1024*1024;
+
+private:
+    struct Header {
+        char magic[8];                                  // "ROSEINSC"
+        boost::uint32_t version;                        // format version number
+        boost::uint32_t recordSize;                     // sizeof(Record)
+        boost::uint64_t nRecords;                       // capacity of the table
+        boost::uint64_t reserved[5];                    // pad header to 64 bytes
+    };
+
+    static const size_t maxDataSize = 112;              // bytes available for an encoded instruction
+
+    struct Record {
+        boost::uint64_t key;                            // primary hash of the key; zero means the slot is empty
+        boost::uint32_t check;                          // secondary hash of key mixed with the data
+        boost::uint8_t dataSize;                        // number of bytes used in data
+        boost::uint8_t reserved[3];
+        boost::uint8_t data[maxDataSize];               // encoded instruction
+    };
+
+    static const boost::uint32_t formatVersion = 2;
+    static const size_t maxProbes = 16;                 // linear probing limit before overwriting
+
+    std::string fileName_;
+    boost::iostreams::mapped_file file_;
+    Header *header_;
+    Record *records_;
+    size_t nHits_, nMisses_, nInserts_;
+
+protected:
+    InstructionCache(const std::string &fileName, size_t capacity);
+
+public:
+    ~InstructionCache();
+
+    /** Open or create a cache file.
+     *
+     *  If the file doesn't exist then a new empty cache with room for @p capacity records is created.  If it exists and is an
+     *  instruction cache then its records are used, or it is reinitialized if it was written with a different format version
+     *  or record size.  Throws an <code>std::runtime_error</code> if the file exists but is not an instruction cache (in which
+     *  case it is left untouched), or if it cannot be created or mapped. */
+    static Ptr instance(const std::string &fileName, size_t capacity = defaultCapacity) {
+        return Ptr(new InstructionCache(fileName, capacity));
+    }
+
+    /** String that identifies a disassembler's architecture for the purpose of keys.
+     *
+     *  Two disassemblers that produce the same string must decode every byte sequence the same way. */
+    static std::string architecture(const Disassembler*);
+
+    /** Look up bytes.
+     *
+     *  The @p bytes are the first @p nBytes bytes of memory at @p va that the disassembler would be allowed to read, up to
+     *  @ref keySize bytes.  Returns a new instruction that is identical to what the disassembler produced for the same key, or
+     *  null if the key is not cached.  The caller owns the returned instruction. */
+    SgAsmInstruction* lookup(const std::string &architecture, rose_addr_t va, const uint8_t *bytes, size_t nBytes);
+
+    /** Insert or replace the instruction for some bytes.
+     *
+     *  Arguments have the same meaning as for @ref lookup.  The instruction is encoded into the cache; it is not retained.
+     *  Returns false, and leaves the cache unchanged, if the instruction cannot be represented in the cache. */
+    bool insert(const std::string &architecture, rose_addr_t va, const uint8_t *bytes, size_t nBytes,
+                const SgAsmInstruction*);
+
+    /** Name of the cache file. */
+    const std::string& fileName() const { return fileName_; }
+
+    /** Number of records the file can hold. */
+    size_t capacity() const { return header_->nRecords; }
+
+    /** Statistics for this process.
+     *
+     * @{ */
+    size_t nHits() const { return nHits_; }
+    size_t nMisses() const { return nMisses_; }
+    size_t nInserts() const { return nInserts_; }
+    /** @} */
+
+private:
+    bool map(boost::iostreams::mapped_file::size_type newFileSize);
+    void initialize(size_t capacity);
+    static void hashKey(const std::string &architecture, rose_addr_t va, const uint8_t *bytes, size_t nBytes,
+                        boost::uint64_t &key /*out*/, boost::uint32_t &check /*out*/);
+    static boost::uint32_t mixCheck(boost::uint32_t check, const boost::uint8_t *data, size_t dataSize);
+};
+
+} // namespace
+} // namespace
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "Disassembler.h"
 #include "BaseSemantics2.h"
+#include "InstructionCache.h"
 
 #include <sawyer/Assert.h>
 #include <sawyer/Map.h>
@@ -33,6 +34,8 @@ private:
     MemoryMap memMap_;
     mutable InsnMap insnMap_;                           // this is a cache
     bool useDisassembler_;
+    InstructionCache::Ptr diskCache_;                   // optional persistent cache of disassembled instructions
+    std::string diskCacheArchitecture_;                 // architecture key for diskCache_
 
 protected:
     InstructionProvider(Disassembler *disassembler, const MemoryMap &map)
@@ -66,6 +69,34 @@ public:
     void disableDisassembler() { useDisassembler_ = false; }
     /** @} */
 
+    /** Property: persistent instruction cache.
+     *
+     *  If non-null, then the on-disk cache is consulted before calling the disassembler for an address that isn't in the
+     *  in-memory cache, and the disassembler's results are recorded in it.  Instructions returned are identical whether or
+     *  not a disk cache is used.  See @ref InstructionCache.
+     *
+     * @{ */
+    const InstructionCache::Ptr& diskCache() const { return diskCache_; }
+    void diskCache(const InstructionCache::Ptr &cache) {
+        diskCache_ = cache;
+        diskCacheArchitecture_ = cache ? InstructionCache::architecture(disassembler_) : std::string();
+    }
+    /** @} */
+
+    /** Look up an instruction in the persistent cache.
+     *
+     *  Returns a new instruction rebuilt from the @ref diskCache for the bytes at @p va in this provider's memory map, or null
+     *  if there is no disk cache or it has no entry for those bytes.  The disassembler is never called and the in-memory cache
+     *  is not modified.  The disk cache is not thread safe. */
+    SgAsmInstruction* diskCacheLookup(rose_addr_t va) const;
+
+    /** Record an instruction in the persistent cache.
+     *
+     *  Records an instruction that was decoded from the bytes at its address in this provider's memory map (for instance, by
+     *  @ref disassemble from a private copy of those bytes).  Does nothing if there is no @ref diskCache.  The disk cache is
+     *  not thread safe. */
+    void diskCacheInsert(const SgAsmInstruction*) const;
+
     /** Returns the instruction at the specified virtual address, or null.
      *
      *  If the virtual address is non-executable then a null pointer is returned, otherwise either a valid instruction or an
@@ -74,6 +105,20 @@ public:
      *  are not executable. */
     SgAsmInstruction* operator[](rose_addr_t va) const;
 
+    /** Disassemble one instruction without using any cache.
+     *
+     *  This is the decoding step used by @ref operator[] when an address is not yet cached, exposed so that callers can
+     *  decode instructions speculatively with their own disassembler and memory map (e.g., a cloned disassembler and a
+     *  private copy of some bytes, one per thread) and then hand the results to @ref insert.  The return value follows the
+     *  same rules as @ref operator[]: null if @p va is not executable, otherwise a valid or "unknown" instruction. */
+    static SgAsmInstruction* disassemble(Disassembler*, const MemoryMap&, rose_addr_t va);
+
+    /** Whether an address is cached.
+     *
+     *  Returns true if the cache has an entry for the specified address, either an instruction or a null pointer indicating
+     *  that no instruction exists there. */
+    bool isCached(rose_addr_t va) const { return insnMap_.exists(va); }
+
     /** Insert an instruction into the cache.
      *
      *  This instruction provider saves a pointer to the instruction without taking ownership.  If an instruction already
@@ -86,6 +131,12 @@ public:
      *  provider, but must not be freed until after the instruction provider is destroyed. */
     Disassembler* disassembler() const { return disassembler_; }
 
+    /** Returns the memory map.
+     *
+     *  Returns the memory map from which instructions are disassembled.  This is the copy that was made when the provider was
+     *  constructed. */
+    const MemoryMap& memoryMap() const { return memMap_; }
+
     /** Returns number of cached starting addresses.
      *
      *  The number of cached starting addresses includes those addresses where an instruction exists, and those addresses where
@@ -117,6 +168,10 @@ public:
      *  in which case a null pointer is returned.  The returned dispatcher is not connected to any semantic domain, so it can
      *  only be used to call its virtual constructor to create a valid dispatcher. */
     InstructionSemantics2::BaseSemantics::DispatcherPtr dispatcher() const { return disassembler_->dispatcher(); }
+
+private:
+    SgAsmInstruction* disassembleWithDiskCache(rose_addr_t va) const;
+    size_t diskCacheKey(rose_addr_t va, uint8_t *bytes /*out*/) const;
 };
 
 } // namespace
@@ -1072,6 +1072,30 @@ class EasyStorage < std::map<SgNode*, std::string> >
      static void readFromFile (std::istream& in);
    };
 
+// EasyStorage for SgNodeStringMap (the hash tables of mangled and qualified names in SgNode), stored the same way
+// as a std::map<SgNode*,std::string>
+template <>
+class EasyStorage < SgNodeStringMap >
+   : public EasyStorage < std::map<SgNode*, std::string> >
+   {
+     typedef EasyStorage < std::map<SgNode*, std::string> > Base;
+    public:
+     void storeDataInEasyStorageClass(const SgNodeStringMap& data_);
+     SgNodeStringMap rebuildDataStoredInEasyStorageClass() const;
+   };
+
+// EasyStorage for SgMangledNameMap (SgNode's cache of interned mangled names), stored the same way as a
+// std::map<SgNode*,std::string>
+template <>
+class EasyStorage < SgMangledNameMap >
+   : public EasyStorage < std::map<SgNode*, std::string> >
+   {
+     typedef EasyStorage < std::map<SgNode*, std::string> > Base;
+    public:
+     void storeDataInEasyStorageClass(const SgMangledNameMap& data_);
+     SgMangledNameMap rebuildDataStoredInEasyStorageClass() const;
+   };
+
 // Liao 1/23/2013, placeholder for storing std::map <SgSymbol*, std::vector <std::pair <SgExpression*, SgExpression*> > >
 // this is used for representing array dimension information of the map clause.
 // TODO: provide real storage support once the OpenMP Accelerator Model is standardized.
@@ -70,12 +70,12 @@ class HiddenListTraversal : public AstTopDownBottomUpProcessing<HiddenListInheri
        // to the static data members in SgNode, but this does not permit the proper handling of nexted types in 
        // templates since the unparser uses the SgNode static members directly.  so the switch to make this a 
        // reference fixes this problem.
-          std::map<SgNode*,std::string> & qualifiedNameMapForNames;
-          std::map<SgNode*,std::string> & qualifiedNameMapForTypes;
+          SgNodeStringMap & qualifiedNameMapForNames;
+          SgNodeStringMap & qualifiedNameMapForTypes;
 
        // DQ (6/3/2011): This is to save the names of types where they can be named differently when referenced 
        // from different locations in the source code.
-          std::map<SgNode*,std::string> & typeNameMap;
+          SgNodeStringMap & typeNameMap;
 
        // Member functions: 
           std::list<SgNode*> gatherNamesInClass( SgClassDefinition* classDefinition );
@@ -83,7 +83,7 @@ class HiddenListTraversal : public AstTopDownBottomUpProcessing<HiddenListInheri
      public:
        // HiddenListTraversal();
        // HiddenListTraversal(SgNode* root);
-          HiddenListTraversal(std::map<SgNode*,std::string> & input_qualifiedNameMapForNames, std::map<SgNode*,std::string> & input_qualifiedNameMapForTypes, std::map<SgNode*,std::string> & input_typeNameMap, std::set<SgNode*> & input_referencedNameSet);
+          HiddenListTraversal(SgNodeStringMap & input_qualifiedNameMapForNames, SgNodeStringMap & input_qualifiedNameMapForTypes, SgNodeStringMap & input_typeNameMap, std::set<SgNode*> & input_referencedNameSet);
 
        // Evaluates how much name qualification is required (typically 0 (no qualification), but sometimes 
        // the depth of the nesting of scopes plus 1 (full qualification with global scoping operator)).
@@ -157,8 +157,8 @@ class HiddenListTraversal : public AstTopDownBottomUpProcessing<HiddenListInheri
           void evaluateNameQualificationForTemplateArgumentList ( SgTemplateArgumentPtrList & templateArgumentList, SgScopeStatement* currentScope, SgStatement* positionStatement );
 
        // DQ (5/28/2011): Added support to set the global qualified name map.
-          const std::map<SgNode*,std::string> & get_qualifiedNameMapForNames() const;
-          const std::map<SgNode*,std::string> & get_qualifiedNameMapForTypes() const;
+          const SgNodeStringMap & get_qualifiedNameMapForNames() const;
+          const SgNodeStringMap & get_qualifiedNameMapForTypes() const;
 
        // DQ (6/3/2011): Evaluate types to permit the strings representing unparsing the types 
        // are saved in a separate map associated with the IR node referencing the type.  This 
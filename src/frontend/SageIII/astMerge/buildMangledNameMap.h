@@ -2,6 +2,9 @@
 #define ROSE_BUILD_MANGLED_NAME_MAP_H
 
 #include <string>
+#include <utility>
+#include <vector>
+#include "InternedString.h"
 //#include "sage3.h"
 
 
@@ -47,7 +50,9 @@ class MangledNameMapTraversal : public ROSE_VisitTraversal
 #else
           // CH (4/13/2010): Use boost::hash<string> instead
           //typedef rose_hash::unordered_map<std::string, SgNode*, rose_hash::hash_string, rose_hash::eqstr_string> MangledNameMapType;
-          typedef rose_hash::unordered_map<std::string, SgNode*> MangledNameMapType;
+          // The keys are interned because merging many translation units produces the same long mangled names over and
+          // over; each distinct name is stored once and hashing and comparing keys doesn't look at the characters.
+          typedef rose_hash::unordered_map<rose::InternedString, SgNode*> MangledNameMapType;
 #endif
        // The delete list is just a set
           typedef std::set<SgNode*> SetOfNodesType;
@@ -63,6 +68,11 @@ class MangledNameMapTraversal : public ROSE_VisitTraversal
           SetOfNodesType     & setOfNodesToDelete;
           SetOfNodesType     setOfNodesPreviouslyVisited;
 
+       // When not NULL, addToMap() appends its arguments here (in the order of the calls) instead of updating the map and
+       // the delete set, so that the map can be built later by generateMangledNameMapInParallel().
+          typedef std::vector<std::pair<rose::InternedString,SgNode*> > CandidateListType;
+          CandidateListType * candidates;
+
           void visit ( SgNode* node);
           void addToMap ( std::string key, SgNode* node);
 
@@ -73,7 +83,7 @@ class MangledNameMapTraversal : public ROSE_VisitTraversal
        // This function determines if we will share the IR node
           static bool shareableIRnode ( const SgNode* node );
 
-          MangledNameMapTraversal ( MangledNameMapType & m, SetOfNodesType & deleteSet );
+          MangledNameMapTraversal ( MangledNameMapType & m, SetOfNodesType & deleteSet, CandidateListType * candidateList = NULL );
 
        // This avoids a warning by g++
           virtual ~MangledNameMapTraversal(){};
@@ -1,7 +1,8 @@
 #ifndef __FIXUPTRAV
 #define __FIXUPTRAV
 
-class FixupTraversal : public ROSE_VisitTraversal
+// Each visit only modifies the data members of the visited IR node, so the memory pools can be traversed in parallel.
+class FixupTraversal : public ROSE_ParallelVisitTraversal
    {
      public:
           int numberOfNodes;
@@ -26,6 +27,9 @@ class FixupTraversal : public ROSE_VisitTraversal
 
           void visit ( SgNode* node);
 
+          ROSE_ParallelVisitTraversal* clone() const;
+          void reduce ( ROSE_ParallelVisitTraversal & worker );
+
           void resetChildren ( SgNode* node, SgNode** pointerToKey, SgNode* key, SgNode* originalNode, const std::string & datamember );
 
        // This avoids a warning by g++
@@ -37,7 +41,9 @@ class FixupTraversal : public ROSE_VisitTraversal
 // addAssociatedNodes() function to detect related IR nodes to be both saved and deleted 
 // (via set_difference algorithm).
 // void fixupTraversal(ReplacementMapTraversal::ReplacementMapType & replacementMap );
-void fixupTraversal( const ReplacementMapTraversal::ReplacementMapType & replacementMap, const std::set<SgNode*> & deleteList );
+// The number of threads is as for AST_FILE_IO::setNumberOfThreads(): zero means one per processor and one means the
+// memory pools are traversed by the calling thread.
+void fixupTraversal( const ReplacementMapTraversal::ReplacementMapType & replacementMap, const std::set<SgNode*> & deleteList, size_t nThreads = 1 );
 
 
 // DQ (2/25/2009): Function added to support similar concept for AST outlining.
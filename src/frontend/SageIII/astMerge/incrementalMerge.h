@@ -0,0 +1,78 @@
+#ifndef ROSE_INCREMENTAL_MERGE_H
+#define ROSE_INCREMENTAL_MERGE_H
+
+#include <map>
+#include <vector>
+#include <boost/unordered_set.hpp>
+#include "buildMangledNameMap.h"
+#include "buildReplacementMap.h"
+
+// Merges files into a project whose AST has already been merged (by mergeAST(), or read by AST_FILE_IO from a file that was
+// written after merging), doing the work of mergeAST() only for the IR nodes of the added files.
+//
+// The constructor visits the whole AST once to build the mangled name map. After that, adding a file generates unique names
+// for, fixes up and deletes only the IR nodes that are reachable from the new file (and not from the AST that was already
+// merged). Of the existing IR nodes, only the global type tables and the types that the new nodes point to are fixed up: the
+// frontend can make such a type point back to a type built for the new file (for example the pointer type of a shared base
+// type), and a type built from an existing type always points to it. For example:
+//
+//      IncrementalAstMerge merge(project);               // project read by AST_FILE_IO::readASTFromFile()
+//      merge.replaceFile(oldFile,newFile);               // newFile built by the frontend for the changed source file
+//      merge.deleteUnreachableNodes();                   // optional, see below
+//      AST_FILE_IO::writeASTToFile(...);
+//
+// Replacing a file removes the mangled names declared by the old file, so that the declarations of the new file take their
+// place. When other files were merged with one of the old file's declarations and the new file declares it again, the other
+// files are redirected to the new declaration by one fixup traversal of the memory pools (this is the only step that
+// visits the whole AST). Declarations of the old file that the new file doesn't declare again stay shared, since other files
+// may use them, and are counted as declarations of the new file. Removing a file removes its mangled names too, and a file
+// that is added later and declares one of them again takes its place as for replacing. The IR nodes of a replaced or removed
+// file are not deleted until deleteUnreachableNodes() is called.
+//
+// IR nodes must not be deleted by other means while this object is in use.
+class IncrementalAstMerge
+   {
+     public:
+          typedef boost::unordered_set<SgNode*> SetOfNodesType;
+
+          IncrementalAstMerge ( SgProject* project );
+
+       // Adds the file to the project (if it isn't in the project already) and merges it.
+          void addFile ( SgFile* file );
+
+       // Removes the old file from the project and merges the new file in its place.
+          void replaceFile ( SgFile* oldFile, SgFile* newFile );
+
+       // Removes the file from the project and the names it declared from the mangled name map. Other files that use its shared
+       // IR nodes are redirected to the declarations of a file that is added later and declares the same names; otherwise
+       // deleteUnreachableNodes() deletes the IR nodes that are no longer used and names the others again.
+          void removeFile ( SgFile* file );
+
+       // Deletes the IR nodes that can no longer be reached from the project, such as those of replaced files. This visits
+       // the whole AST, so it is meant to be called once after a batch of changes.
+          void deleteUnreachableNodes ();
+
+          const MangledNameMapTraversal::MangledNameMapType & get_mangledNameMap () const { return mangledNameMap; }
+
+     private:
+          SgProject* project;
+
+       // Unique names of the shared IR nodes of the merged AST
+          MangledNameMapTraversal::MangledNameMapType mangledNameMap;
+
+       // The file that declared each IR node in the mangledNameMap, and the names declared by each file
+          std::map<SgNode*,SgFile*> fileOfSharedNode;
+          std::map<SgFile*,std::vector<rose::InternedString> > namesOfFile;
+
+       // Names declared by removed files that no file has declared again since, and their IR nodes
+          std::map<rose::InternedString,SgNode*> namesOfRemovedFiles;
+
+       // All IR nodes of the merged AST
+          SetOfNodesType mergedNodes;
+
+          void mergeFile ( SgFile* file, std::map<rose::InternedString,SgNode*> & namesOfReplacedFile );
+          void collectNewNodes ( SgFile* file, std::vector<SgNode*> & newNodes, std::vector<SgNode*> & referencedTypes ) const;
+          void detachFile ( SgFile* file, std::map<rose::InternedString,SgNode*> & names );
+   };
+
+#endif // ROSE_INCREMENTAL_MERGE_H
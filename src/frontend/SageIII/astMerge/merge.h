@@ -11,6 +11,8 @@
 #include "deleteOrphanNodes.h"
 #include "buildReplacementMap.h"
 #include "fixupTraversal.h"
+#include "parallelMerge.h"
+#include "incrementalMerge.h"
 #include "collectAssociateNodes.h"
 #include "requiredNodes.h"
 
@@ -27,6 +29,12 @@ void deleteSetErrorCheck( SgProject* project, const std::set<SgNode*> & listToDe
 
 void mergeAST ( SgProject* project, bool skipFrontendSpecificIRnodes = false );
 
+// Number of threads used by mergeAST(). One, the default, means the mangled name map, the replacement map and the fixup
+// are computed by the calling thread as before; any other value builds the maps by partitions (see parallelMerge.h) and
+// fixes up the memory pools in parallel, with the same result. Zero means one thread per processor.
+void setAstMergeNumberOfThreads ( size_t nThreads );
+size_t getAstMergeNumberOfThreads ();
+
 
 // DQ (7/3/2010): Implementation of alternative appraoch to define the list 
 // of redundant nodes to delete based on the detection of nodes disconnected 
@@ -0,0 +1,66 @@
+#ifndef ROSE_PARALLEL_MERGE_H
+#define ROSE_PARALLEL_MERGE_H
+
+#include <vector>
+#include "buildMangledNameMap.h"
+#include "buildReplacementMap.h"
+
+// Collects the names of the sharable IR nodes. The base class records the arguments of its addToMap() calls (including those
+// for the static types made by its constructor, which is why the list is not a member of this class) and this class adds the
+// names of all the sharable nodes, reusing the names generated by the base class. Also used by IncrementalAstMerge, which
+// calls visit() directly for the nodes of one file.
+class MergeNameTraversal : public MangledNameMapTraversal
+   {
+     public:
+       // Sharable nodes with a non-empty name, in the order visited
+          CandidateListType sharableNodes;
+
+          MergeNameTraversal ( MangledNameMapType & unusedMap, SetOfNodesType & unusedDeleteSet, CandidateListType & candidateList );
+
+          void visit ( SgNode* node );
+   };
+
+// Parallel versions of generateMangledNameMap() and replacementMapTraversal(), used by mergeAST() when it is asked to use
+// more than one thread (see setAstMergeNumberOfThreads()).
+//
+// The unique names of the sharable IR nodes are generated by the calling thread in a single memory pool traversal, since
+// generateUniqueName() unparses and updates the mangled name caches, and each name is generated only once instead of once
+// per traversal. The nodes are then divided into partitions by the hash of their name so that all nodes with the same name
+// are in the same partition, in memory pool order. Each partition builds its part of the mangled name map and of the
+// replacement map in a separate task and the parts are combined in partition order. The results are the same as those of
+// the sequential traversals for any number of threads.
+class MergePartitions
+   {
+     public:
+       // Unique name and IR node
+          typedef std::pair<rose::InternedString,SgNode*> EntryType;
+
+          struct Partition
+             {
+            // The nodes passed to MangledNameMapTraversal::addToMap() by the sequential traversal, in the same order
+               std::vector<EntryType> candidates;
+
+            // All sharable nodes with a non-empty name, in memory pool order
+               std::vector<EntryType> sharableNodes;
+
+            // Results for this partition
+               MangledNameMapTraversal::MangledNameMapType mangledNameMap;
+               std::vector<SgNode*> setOfNodesToDelete;
+               std::vector<std::pair<SgNode*,SgNode*> > replacements;
+             };
+
+          std::vector<Partition> partitions;
+          size_t nThreads;
+
+       // A thread count of zero means one thread per processor
+          MergePartitions ( size_t nThreads );
+   };
+
+void generateMangledNameMapInParallel ( MangledNameMapTraversal::MangledNameMapType & mangledMap, MangledNameMapTraversal::SetOfNodesType & setOfIRnodesToDelete, MergePartitions & partitions );
+
+void replacementMapTraversalInParallel (
+   ReplacementMapTraversal::ReplacementMapType & replacementMap,
+   ReplacementMapTraversal::ListToDeleteType   & deleteList,
+   MergePartitions                             & partitions );
+
+#endif // ROSE_PARALLEL_MERGE_H
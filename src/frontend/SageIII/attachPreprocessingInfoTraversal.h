@@ -130,7 +130,24 @@ class AttachPreprocessingInfoTreeTrav
       // include files (except should specified using exclusion lists via the command line).
          bool processAllIncludeFiles;
 
+      // File ids of the source file and of its C preprocessor intermediate file, looked up on first use (-1 until then)
+      // since they are required for every located node that is visited.
+         int sourceFileId;
+         int preprocessedFileId;
+
+      // The file id used to select the list of comments and CPP directives for an IR node: the id of the C preprocessor
+      // intermediate file if the source file requires CPP, otherwise the physical file id of the node.
+         int getFileIdForAttachment ( Sg_File_Info* fileInfo );
+
+      // True if the comments and CPP directives of the file are those of the source file (as opposed to an include file).
+         bool isSourceFileOfTraversal ( const std::string & fileName );
+
      public:
+      // Lexes a C or C++ include file, or rebuilds its comments and CPP directives from an earlier lex of the same file (by
+      // this or another traversal) if the file hasn't changed. The raw token stream of a rebuilt list is empty. The cache
+      // holds no IR nodes, so it is not seen by memory pool traversals or written by AST_FILE_IO.
+         static ROSEAttributesList* getCachedPreprocessorDirectives ( const std::string & fileName );
+
        // DQ (9/24/2007): Moved function definition to source file from header file.
        // AS(011306) Constructor for use of Wave Preprocessor
           AttachPreprocessingInfoTreeTrav( std::map<std::string,ROSEAttributesList*>* attrMap);
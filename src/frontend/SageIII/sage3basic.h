@@ -287,6 +287,19 @@
    #error "DEFAULT_CLASS_ALLOCATION_POOL_SIZE must be greater than zero!"
 #endif
 
+// Number of free IR nodes that each thread caches per IR node type so that the generated new and delete operators usually
+// need not lock the type's allocation mutex.  A thread's cache is refilled from the global free list in batches of this many
+// objects and returns half of its objects when it holds twice this many.
+#define DEFAULT_CLASS_ALLOCATION_THREAD_CACHE_SIZE 64
+
+// A memory pool grows by twice as many blocks as the previous time it grew, but never by more than this many blocks at once.
+#define MAX_CLASS_ALLOCATION_CHUNK_BLOCKS 64
+
+// Storage class for the per-thread memory pool caches. When it's not defined, every allocation locks the mutex.
+#if defined(__GNUC__) && !defined(_MSC_VER)
+   #define ROSE_POOL_THREAD_LOCAL __thread
+#endif
+
 // DQ (3/7/2010): This is no longer used (for several years) and we use an STL based implementation.
 // #define MAX_NUMBER_OF_MEMORY_BLOCKS        1000
 
@@ -0,0 +1,126 @@
+#ifndef FLAT_CFG_H
+#define FLAT_CFG_H
+
+#include <sage3basic.h>
+#include "virtualCFG.h"
+#include "filteredCFG.h"
+#include <utility>
+#include <vector>
+
+
+namespace StaticCFG
+{
+
+using VirtualCFG::CFGNode;
+using VirtualCFG::EdgeConditionKind;
+
+
+//! An immutable snapshot of the CFG of a function (or of any other node with a virtual CFG), built once by following
+//! the edges of the virtual CFG. The nodes have dense ids (0 to size()-1) and the successors and predecessors of all the
+//! nodes are stored in two contiguous arrays (compressed sparse row format), so that the graph can be iterated without
+//! recomputing edges from the AST and without allocating:
+//!
+//!     StaticCFG::FlatCFG cfg(functionDefinition);
+//!     for (StaticCFG::FlatCFG::const_iterator s = cfg.succBegin(n); s != cfg.succEnd(n); ++s)
+//!         ...  // *s is the id of a successor of n
+//!
+//! The nodes reachable from the entry have the lowest ids, in reverse postorder (so a forward dataflow analysis that
+//! visits the nodes in id order sees a node after its predecessors, except along back edges). Other nodes (only found
+//! by following incoming edges) follow them in the order found.
+class ROSE_DLL_API FlatCFG
+{
+public:
+    typedef unsigned int NodeId;
+    typedef const NodeId* const_iterator;
+
+    //! The id returned for nodes that are not in the graph.
+    static const NodeId invalidId = ~0u;
+
+    //! Build the CFG starting at the beginning of the given node. If is_filtered is true, only the interesting nodes
+    //! (see VirtualCFG::InterestingNode) are included.
+    /*! The valid nodes are SgStatement, SgExpression and SgInitializedName, usually a SgFunctionDefinition. */
+    FlatCFG(SgNode* start, bool is_filtered = false);
+
+    //! Build the CFG of the nodes accepted by the filter of a VirtualCFG::FilteredCFGNode (see filteredCFG.h), starting
+    //! at the given node, for example FilteredCFGNode<IsDFAFilter>(functionDefinition->cfgForBeginning()).
+    template <class FilterFunction>
+    explicit FlatCFG(const VirtualCFG::FilteredCFGNode<FilterFunction>& start);
+
+    //! The number of nodes.
+    size_t size() const { return nodes_.size(); }
+
+    //! The number of edges.
+    size_t numberOfEdges() const { return succs_.size(); }
+
+    bool isFilteredCFG() const { return is_filtered_; }
+
+    //! The node for the beginning of the start node.
+    NodeId getEntry() const { return entry_; }
+
+    //! The node for the end of the start node, or invalidId if it can't be reached.
+    NodeId getExit() const { return exit_; }
+
+    //! The virtual CFG node with the given id.
+    const CFGNode& toCFGNode(NodeId n) const { return nodes_[n]; }
+
+    //! The AST node of the node with the given id.
+    SgNode* getNode(NodeId n) const { return nodes_[n].getNode(); }
+
+    //! The index within its AST node of the node with the given id.
+    unsigned int getIndex(NodeId n) const { return nodes_[n].getIndex(); }
+
+    //! The id of a virtual CFG node, or invalidId if it isn't in the graph.
+    NodeId getId(const CFGNode& n) const;
+
+    //! Provide the same interface as CFG to get the nodes for the beginning/end of an AST node.
+    NodeId cfgForBeginning(SgNode* node) const { return getId(node->cfgForBeginning()); }
+    NodeId cfgForEnd(SgNode* node) const { return getId(node->cfgForEnd()); }
+
+    //! Successors of a node, in the order of the edges of the virtual CFG.
+    const_iterator succBegin(NodeId n) const { return data(succs_) + succOffsets_[n]; }
+    const_iterator succEnd(NodeId n) const { return data(succs_) + succOffsets_[n + 1]; }
+    size_t numberOfSuccs(NodeId n) const { return succOffsets_[n + 1] - succOffsets_[n]; }
+
+    //! The condition of the edge to the i'th successor of a node.
+    EdgeConditionKind succCondition(NodeId n, size_t i) const { return succConditions_[succOffsets_[n] + i]; }
+
+    //! Predecessors of a node, in increasing id order.
+    const_iterator predBegin(NodeId n) const { return data(preds_) + predOffsets_[n]; }
+    const_iterator predEnd(NodeId n) const { return data(preds_) + predOffsets_[n + 1]; }
+    size_t numberOfPreds(NodeId n) const { return predOffsets_[n + 1] - predOffsets_[n]; }
+
+protected:
+    template <class NodeT, class EdgeT>
+    void buildCFG(NodeT start, NodeT end);
+
+    static const NodeId* data(const std::vector<NodeId>& v) { return v.empty() ? NULL : &v[0]; }
+
+    //! Compares the (node, id) pairs of ids_ by node only.
+    struct LessNode
+    {
+        bool operator()(const std::pair<CFGNode, NodeId>& a, const std::pair<CFGNode, NodeId>& b) const
+        { return a.first < b.first; }
+    };
+
+    //! The node of each id, and the ids sorted by node (for getId()).
+    std::vector<CFGNode> nodes_;
+    std::vector<std::pair<CFGNode, NodeId> > ids_;
+
+    //! Edges in compressed sparse row format: the successors of node n are succs_[succOffsets_[n]] to
+    //! succs_[succOffsets_[n+1]-1], and likewise for predecessors. The offset arrays have size()+1 elements.
+    std::vector<size_t> succOffsets_;
+    std::vector<NodeId> succs_;
+    std::vector<EdgeConditionKind> succConditions_;
+    std::vector<size_t> predOffsets_;
+    std::vector<NodeId> preds_;
+
+    NodeId entry_;
+    NodeId exit_;
+    bool is_filtered_;
+};
+
+} // end of namespace StaticCFG
+
+#include "flatCFGImpl.h"
+
+#endif
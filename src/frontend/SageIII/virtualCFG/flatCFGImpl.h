@@ -0,0 +1,163 @@
+#ifndef FLAT_CFG_IMPL_H
+#define FLAT_CFG_IMPL_H
+
+#include <algorithm>
+#include <map>
+#include <boost/foreach.hpp>
+
+
+namespace StaticCFG
+{
+
+template <class FilterFunction>
+FlatCFG::FlatCFG(const VirtualCFG::FilteredCFGNode<FilterFunction>& start)
+    : entry_(invalidId), exit_(invalidId), is_filtered_(true)
+{
+    ROSE_ASSERT(start.getNode() != NULL);
+
+    buildCFG<VirtualCFG::FilteredCFGNode<FilterFunction>, VirtualCFG::FilteredCFGEdge<FilterFunction> >
+        (start, VirtualCFG::FilteredCFGNode<FilterFunction>(start.getNode()->cfgForEnd()));
+}
+
+template <class NodeT, class EdgeT>
+void FlatCFG::buildCFG(NodeT start, NodeT end)
+{
+    ROSE_ASSERT(start.getNode());
+
+    // Find all the nodes by following both the outgoing and incoming edges (as CFG::buildCFG() does), numbering them in
+    // the order found. The outgoing edges of each node are recorded with these temporary numbers.
+    std::vector<NodeT> found;
+    std::map<NodeT, size_t> numbers;
+    std::vector<std::vector<std::pair<size_t, EdgeConditionKind> > > outEdges;
+
+    numbers[start] = 0;
+    found.push_back(start);
+    for (size_t current = 0; current < found.size(); ++current)
+    {
+        // Copy the node, since found can grow while its edges are processed.
+        NodeT n = found[current];
+
+        std::vector<std::pair<size_t, EdgeConditionKind> > targets;
+        BOOST_FOREACH (const EdgeT& edge, n.outEdges())
+        {
+            ROSE_ASSERT(edge.source() == n);
+            NodeT tar = edge.target();
+            typename std::map<NodeT, size_t>::iterator number = numbers.find(tar);
+            if (number == numbers.end())
+            {
+                number = numbers.insert(std::make_pair(tar, found.size())).first;
+                found.push_back(tar);
+            }
+            targets.push_back(std::make_pair(number->second, edge.condition()));
+        }
+        outEdges.push_back(targets);
+
+        BOOST_FOREACH (const EdgeT& edge, n.inEdges())
+        {
+            ROSE_ASSERT(edge.target() == n);
+            NodeT src = edge.source();
+            if (numbers.find(src) == numbers.end())
+            {
+                numbers.insert(std::make_pair(src, found.size()));
+                found.push_back(src);
+            }
+        }
+    }
+
+    // Assign the final ids: reverse postorder of a depth first search from the start node along the outgoing edges,
+    // then the remaining nodes in the order found.
+    const size_t nNodes = found.size();
+    std::vector<NodeId> ids(nNodes, invalidId);
+    std::vector<size_t> postorder;
+    postorder.reserve(nNodes);
+    {
+        std::vector<bool> visited(nNodes, false);
+        std::vector<std::pair<size_t, size_t> > stack; // node and the index of its next edge to follow
+        visited[0] = true;
+        stack.push_back(std::make_pair(size_t(0), size_t(0)));
+        while (!stack.empty())
+        {
+            size_t n = stack.back().first;
+            size_t& nextEdge = stack.back().second;
+            if (nextEdge < outEdges[n].size())
+            {
+                size_t tar = outEdges[n][nextEdge++].first;
+                if (!visited[tar])
+                {
+                    visited[tar] = true;
+                    stack.push_back(std::make_pair(tar, size_t(0)));
+                }
+            }
+            else
+            {
+                postorder.push_back(n);
+                stack.pop_back();
+            }
+        }
+    }
+
+    NodeId nextId = 0;
+    for (std::vector<size_t>::reverse_iterator i = postorder.rbegin(); i != postorder.rend(); ++i)
+        ids[*i] = nextId++;
+    for (size_t n = 0; n < nNodes; ++n)
+    {
+        if (ids[n] == invalidId)
+            ids[n] = nextId++;
+    }
+    ROSE_ASSERT(nextId == nNodes);
+
+    // Fill in the node table and the lookup table.
+    nodes_.resize(nNodes);
+    ids_.clear();
+    ids_.reserve(nNodes);
+    for (size_t n = 0; n < nNodes; ++n)
+    {
+        CFGNode node(found[n].getNode(), found[n].getIndex());
+        nodes_[ids[n]] = node;
+        ids_.push_back(std::make_pair(node, ids[n]));
+    }
+    std::sort(ids_.begin(), ids_.end(), LessNode());
+
+    entry_ = ids[0];
+    typename std::map<NodeT, size_t>::const_iterator endNumber = numbers.find(end);
+    exit_ = (endNumber == numbers.end()) ? invalidId : ids[endNumber->second];
+
+    // Build the successor arrays in id order, and count the predecessors of each node.
+    succOffsets_.assign(nNodes + 1, 0);
+    predOffsets_.assign(nNodes + 1, 0);
+    std::vector<size_t> byId(nNodes);
+    for (size_t n = 0; n < nNodes; ++n)
+        byId[ids[n]] = n;
+
+    succs_.clear();
+    succConditions_.clear();
+    for (NodeId id = 0; id < nNodes; ++id)
+    {
+        succOffsets_[id] = succs_.size();
+        typedef std::pair<size_t, EdgeConditionKind> EdgeType;
+        BOOST_FOREACH (const EdgeType& edge, outEdges[byId[id]])
+        {
+            NodeId tar = ids[edge.first];
+            succs_.push_back(tar);
+            succConditions_.push_back(edge.second);
+            ++predOffsets_[tar + 1];
+        }
+    }
+    succOffsets_[nNodes] = succs_.size();
+
+    // Then the predecessor arrays, by a counting sort of the edges on their targets. Since the sources are visited in id
+    // order, the predecessors of each node are sorted.
+    for (size_t id = 0; id < nNodes; ++id)
+        predOffsets_[id + 1] += predOffsets_[id];
+    preds_.resize(succs_.size());
+    std::vector<size_t> nextPred(predOffsets_.begin(), predOffsets_.end() - 1);
+    for (NodeId id = 0; id < nNodes; ++id)
+    {
+        for (size_t i = succOffsets_[id]; i < succOffsets_[id + 1]; ++i)
+            preds_[nextPred[succs_[i]]++] = id;
+    }
+}
+
+} // end of namespace StaticCFG
+
+#endif
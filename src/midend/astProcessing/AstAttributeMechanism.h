@@ -5,8 +5,11 @@
 #define ASTATTRIBUTEMECHANISM_H
 
 #include <list>
+#include <set>
+#include <string>
+#include <vector>
 
-#include "AttributeMechanism.h"
+#include "InternedString.h"
 #include "rosedll.h"
 #include "rose_override.h"
 
@@ -170,16 +173,67 @@ class ROSE_DLL_API MetricAttribute : public AstAttribute
 };
 
 
+/** Typed name of an attribute.
+ *
+ *  A key is constructed once from the attribute's name, which looks up (or assigns) the name's small integer id in the
+ *  process-wide attribute name registry. Attributes accessed through keys are then found by comparing integers and are
+ *  returned with their declared type without a dynamic_cast:
+ *
+ * @code
+ *  static const AstAttributeKey<LVAstAttribute> liveVariables("LVAstAttribute");
+ *  node->setAttribute(liveVariables, new LVAstAttribute(...));
+ *  LVAstAttribute *lv = node->getAttribute(liveVariables);    // null if not present
+ * @endcode
+ *
+ *  All accesses to an attribute name through a typed key must use the same type @p T, and values stored under that name
+ *  through the string interface must also be of that type. Keys should be constructed once (e.g., as static objects) since
+ *  construction locks the registry; using a key locks nothing. */
+template<class T>
+class AstAttributeKey {
+    unsigned id_;
+    rose::InternedString name_;
+public:
+    explicit AstAttributeKey(const std::string &name);
+
+    /** Id of the attribute name. */
+    unsigned id() const { return id_; }
+
+    /** The attribute name. */
+    const rose::InternedString& name() const { return name_; }
+};
+
 // DQ (6/28/2008):
-// Since this is implemented using AttributeMechanism which is derived from
-// std::map<Key,Value>, "Value" is a template parameter for "AstAttribute*"
-// And so the copy constructor will copy the pointer.  This is OK, but it
-// means that the AstAttribute objects are shared.  Alternatively, a copy
-// constructor implemented in this class could be implemented to support
-// deep copies.  This might be a good idea.
-class AstAttributeMechanism : public AttributeMechanism<std::string,AstAttribute*>
+// The copy constructor does a deep copy of the attributes (using AstAttribute::copy) while the
+// assignment operator copies the pointers, which means that the AstAttribute objects are shared.
+//
+// Attributes are stored in a small vector sorted by name, so iteration order is the same as when this was
+// an std::map<std::string,AstAttribute*>. Each entry also holds the integer id of its name, which is what
+// typed lookups compare. Names are mapped to ids by a locked registry shared by all nodes, but it is only
+// consulted when a name is added to a node for the first time: the std::string member functions binary
+// search the node's own entries by name, and AstAttributeKey resolves its id and name once.
+class ROSE_DLL_API AstAttributeMechanism
    {
      public:
+       //! Small integer that identifies an attribute name.
+          typedef unsigned Id;
+
+       //! Id that is never assigned to a name.
+          static const Id INVALID_ID = (Id)(-1);
+
+       //! An attribute. Members "first" and "second" are named as in the former std::map value type.
+          struct value_type
+             {
+               rose::InternedString first;     // attribute name
+               AstAttribute *second;           // attribute value
+               Id id;                          // id of the attribute name
+               value_type(): second(NULL), id(INVALID_ID) {}
+               value_type(const rose::InternedString &name, AstAttribute *value, Id nameId): first(name), second(value), id(nameId) {}
+             };
+
+          typedef std::vector<value_type>::iterator iterator;
+          typedef std::vector<value_type>::const_iterator const_iterator;
+          typedef std::set<std::string> AttributeIdentifiers;
+
        // DQ (7/27/2008): Build a copy constructor that will do a deep copy
        // instead of calling the default copy constructor.
           AstAttributeMechanism ( const AstAttributeMechanism & X );
@@ -187,8 +241,91 @@ class AstAttributeMechanism : public AttributeMechanism<std::string,AstAttribute
        // DQ (7/27/2008): Because we add an explicit copy constructor we
        // now need an explicit default constructor.
           AstAttributeMechanism ();
+
+       //! Id of an attribute name, assigning a new one if the name has never been seen. Thread safe.
+          static Id id(const std::string &name);
+
+       //! Id of an attribute name, or INVALID_ID if the name has never been seen. Thread safe.
+          static Id findId(const std::string &name);
+
+       //! Name corresponding to an id. Thread safe.
+          static rose::InternedString name(Id id);
+
+       //! test if attribute "name" exists (i.e. has been added with add or set)
+          bool exists(const std::string &name) const;
+          bool exists(Id id) const { return find(id) != end(); }
+
+       //! add a new attribute. If attribute already exists, fail.
+          void add(const std::string &name, AstAttribute *data);
+
+       //! replace an existing attribute "name", fail if the attribute does not exist
+          void replace(const std::string &name, AstAttribute *data);
+
+       //! remove an existing attribute name, fail if the attribute does not exist
+          void remove(const std::string &name);
+
+       //! Set a value data for attribute name, adding the attribute if it does not exist.
+          void set(const std::string &name, AstAttribute *data);
+          void set(Id id, AstAttribute *data);
+
+       //! get the set of all attribute identifiers/names
+          AttributeIdentifiers getAttributeIdentifiers() const;
+
+       //! access the value of attribute "name". Fails if the attribute does not exist.
+          AstAttribute* operator[](const std::string &name) const;
+
+       //! Value of an attribute, or null if the attribute does not exist.
+          AstAttribute* get(const std::string &name) const;
+          AstAttribute* get(Id id) const
+             {
+               const_iterator iter = find(id);
+               return iter == end() ? NULL : iter->second;
+             }
+
+       //! Typed access through a key (see AstAttributeKey). Get returns null if the attribute does not exist.
+          template<class T>
+          T* get(const AstAttributeKey<T> &key) const
+             {
+               return static_cast<T*>(get(key.id()));
+             }
+          template<class T>
+          void set(const AstAttributeKey<T> &key, T *data)
+             {
+               iterator found = find(key.id());
+               if (found != end())
+                    found->second = data;
+               else
+                    insert(key.id(), key.name(), data);
+             }
+
+       //! Find an attribute by id.
+          iterator find(Id id);
+          const_iterator find(Id id) const;
+
+       //! Remove an attribute by id if present; returns true if it was present.
+          bool erase(Id id);
+
+       // DQ (1/2/2006): Added member function to return number of attributes in the container
+          int size() const { return attributes_.size(); }
+
+       // Liao, 2/26/2008, support iterator
+          iterator begin() { return attributes_.begin(); }
+          iterator end() { return attributes_.end(); }
+          const_iterator begin() const { return attributes_.begin(); }
+          const_iterator end() const { return attributes_.end(); }
+
+     private:
+          iterator findName(const std::string &name);
+          const_iterator findName(const std::string &name) const;
+          void insert(Id id, const rose::InternedString &name, AstAttribute *data);
+
+          std::vector<value_type> attributes_;
    };
 
+template<class T>
+AstAttributeKey<T>::AstAttributeKey(const std::string &name)
+    : id_(AstAttributeMechanism::id(name)), name_(name) {}
+
 
 // DQ (11/21/2009): Added new kind of attribute for handling regex trees.
 /*!
@@ -262,6 +262,51 @@ private:
     size_t synchronizationWindowSize;
 };
 
+// TASK PARALLEL traversals
+
+// Top-down/bottom-up traversal whose work is divided among threads by subtree rather than by traversal. The classes above
+// run several different traversals in lockstep, one per thread, so their speedup is bounded by the number of traversals. This
+// class instead runs a single traversal and forks the AST's independent subtrees (by default each SgFile and each
+// SgFunctionDefinition) as tasks on a work-stealing thread pool, so one heavy traversal over one large file can use all cores.
+//
+// Users derive from this class exactly as they would from AstTopDownBottomUpProcessing and call traverseInParallel()
+// instead of traverse(); traverse() still runs sequentially.  Inherited attributes are passed down into forked subtrees, and
+// each subtree's synthesized attribute is delivered to its parent, so every node sees the same attribute values as in a
+// sequential traversal and the result is identical.  The differences are:
+//
+//   - evaluateInheritedAttribute(), evaluateSynthesizedAttribute() and defaultSynthesizedAttribute() are called concurrently
+//     for nodes in different subtrees, so they must not modify shared state without locking. Within one subtree the calls
+//     occur in the usual order.
+//   - Successors are always the default traversal successors; overriding setNodeSuccessors() has no effect.
+//   - atTraversalStart() and atTraversalEnd() are called once, by the calling thread.
+//
+// Override isParallelSubtree() to choose which subtrees become tasks. Subtrees that are too small cost more to schedule than
+// they save.
+template <class InheritedAttributeType, class SynthesizedAttributeType>
+class AstTaskParallelTopDownBottomUpProcessing
+    : public AstTopDownBottomUpProcessing<InheritedAttributeType, SynthesizedAttributeType>
+{
+public:
+    typedef AstTopDownBottomUpProcessing<InheritedAttributeType, SynthesizedAttributeType> Superclass;
+    typedef typename Superclass::SynthesizedAttributesList SynthesizedAttributesList;
+
+    // Evaluates attributes on the entire AST using the specified number of threads (zero means the hardware concurrency).
+    SynthesizedAttributeType traverseInParallel(SgNode *basenode, InheritedAttributeType inheritedValue, size_t nThreads = 0);
+
+protected:
+    // Returns true if the subtree rooted at the specified node (other than the traversal's base node) should be traversed
+    // by a separate task. The default forks each SgFile and each SgFunctionDefinition.
+    virtual bool isParallelSubtree(SgNode *node);
+
+private:
+    struct Region;
+    struct Context;
+    void traverseRegion(Context *context, Region *region);
+    void expandRegion(Context *context, Region *region, SgNode *node, InheritedAttributeType inheritedValue, bool isBase);
+    void evaluateRegion(Region *region, size_t &entryIndex, SynthesizedAttributesList &stack);
+    void finishRegion(Context *context, Region *region);
+};
+
 #include "AstSharedMemoryParallelProcessingImpl.h"
 
 #include "AstSharedMemoryParallelSimpleProcessing.h"
@@ -16,6 +16,9 @@
 #endif
 
 #include "AstSharedMemoryParallelProcessing.h"
+#include "WorkStealing.h"
+
+#include <boost/bind.hpp>
 
 // Throughout this file, I is the InheritedAttributeType, S is the
 // SynthesizedAttributeType -- the type names are still horrible
@@ -603,4 +606,175 @@ AstSharedMemoryParallelBottomUpProcessing<S>::set_synchronizationWindowSize(size
 #endif
 }
 
+// parallel TASK implementation
+
+// A region is the part of a forked subtree that is traversed by one task: the subtree minus the nested subtrees that were
+// forked again. The task records the region's nodes in preorder along with their inherited attributes, and evaluates the
+// synthesized attributes after the results of all nested regions have arrived.
+template <class I, class S>
+struct AstTaskParallelTopDownBottomUpProcessing<I, S>::Region
+{
+    struct Entry
+    {
+        SgNode *node;           // null for null successors
+        I inheritedValue;       // the node's inherited attribute; its parent's for null successors and nested regions
+        size_t nSuccessors;     // number of successor entries, which follow this one
+        Region *nested;         // non-null if this node is the root of a nested region
+
+        Entry(SgNode *node, I inheritedValue, size_t nSuccessors, Region *nested)
+            : node(node), inheritedValue(inheritedValue), nSuccessors(nSuccessors), nested(nested)
+        {
+        }
+    };
+
+    SgNode *root;
+    I inheritedValue;           // inherited attribute of the root's parent
+    Region *parent;             // region that receives this region's result
+    std::vector<Entry> entries;
+    size_t nPending;            // this region's own task plus unfinished nested regions; protected by Context::mutex
+    S result;
+
+    Region(SgNode *root, I inheritedValue, Region *parent)
+        : root(root), inheritedValue(inheritedValue), parent(parent), nPending(1)
+    {
+    }
+};
+
+// State shared by all tasks of one parallel traversal.
+template <class I, class S>
+struct AstTaskParallelTopDownBottomUpProcessing<I, S>::Context
+{
+    rose::WorkStealing::Pool pool;
+    boost::mutex mutex;             // protects the following data members and Region::nPending
+    std::vector<Region*> regions;   // all regions, deleted when the traversal is done (even if it failed)
+
+    explicit Context(size_t nThreads)
+        : pool(nThreads)
+    {
+    }
+
+    ~Context()
+    {
+        for (size_t i = 0; i < regions.size(); i++)
+            delete regions[i];
+    }
+
+    Region *newRegion(SgNode *root, I inheritedValue, Region *parent)
+    {
+        boost::lock_guard<boost::mutex> lock(mutex);
+        regions.push_back(new Region(root, inheritedValue, parent));
+        if (parent)
+            parent->nPending++;
+        return regions.back();
+    }
+};
+
+template <class I, class S>
+S
+AstTaskParallelTopDownBottomUpProcessing<I, S>::traverseInParallel(SgNode *basenode, I inheritedValue, size_t nThreads)
+{
+    Context context(nThreads);
+    Region *root = context.newRegion(basenode, inheritedValue, NULL);
+
+    this->atTraversalStart();
+    context.pool.submit(boost::bind(&AstTaskParallelTopDownBottomUpProcessing::traverseRegion, this, &context, root));
+    context.pool.wait();
+    this->atTraversalEnd();
+
+    return root->result;
+}
+
+template <class I, class S>
+bool
+AstTaskParallelTopDownBottomUpProcessing<I, S>::isParallelSubtree(SgNode *node)
+{
+    return isSgFile(node) != NULL || isSgFunctionDefinition(node) != NULL;
+}
+
+// This is the body of each task.
+template <class I, class S>
+void
+AstTaskParallelTopDownBottomUpProcessing<I, S>::traverseRegion(Context *context, Region *region)
+{
+    expandRegion(context, region, region->root, region->inheritedValue, true);
+    finishRegion(context, region);
+}
+
+// Top-down part of a region: evaluates inherited attributes in preorder like SgTreeTraversal::performTraversal() does and
+// forks nested regions as soon as they are found so they run while this region is still being traversed.
+template <class I, class S>
+void
+AstTaskParallelTopDownBottomUpProcessing<I, S>::expandRegion(Context *context, Region *region, SgNode *node,
+                                                            I inheritedValue, bool isBase)
+{
+    typedef typename Region::Entry Entry;
+
+    if (node == NULL)
+    {
+        region->entries.push_back(Entry(NULL, inheritedValue, 0, NULL));
+    }
+    else if (!isBase && isParallelSubtree(node))
+    {
+        Region *nested = context->newRegion(node, inheritedValue, region);
+        region->entries.push_back(Entry(node, inheritedValue, 0, nested));
+        context->pool.submit(boost::bind(&AstTaskParallelTopDownBottomUpProcessing::traverseRegion, this, context, nested));
+    }
+    else
+    {
+        I value = this->evaluateInheritedAttribute(node, inheritedValue);
+        size_t numberOfSuccessors = node->get_numberOfTraversalSuccessors();
+        region->entries.push_back(Entry(node, value, numberOfSuccessors, NULL));
+        for (size_t idx = 0; idx < numberOfSuccessors; idx++)
+            expandRegion(context, region, node->get_traversalSuccessorByIndex(idx), value, false);
+    }
+}
+
+// Bottom-up part of a region: evaluates synthesized attributes in postorder on a stack, the same way as
+// SgTreeTraversal::performTraversal() does. Nested regions contribute their results.
+template <class I, class S>
+void
+AstTaskParallelTopDownBottomUpProcessing<I, S>::evaluateRegion(Region *region, size_t &entryIndex,
+                                                              SynthesizedAttributesList &stack)
+{
+    const typename Region::Entry &entry = region->entries[entryIndex++];
+    if (entry.nested)
+    {
+        stack.push(entry.nested->result);
+    }
+    else if (entry.node == NULL)
+    {
+        stack.push(this->defaultSynthesizedAttribute(entry.inheritedValue));
+    }
+    else
+    {
+        for (size_t idx = 0; idx < entry.nSuccessors; idx++)
+            evaluateRegion(region, entryIndex, stack);
+        stack.setFrameSize(entry.nSuccessors);
+        stack.push(this->evaluateSynthesizedAttribute(entry.node, entry.inheritedValue, stack));
+    }
+}
+
+// Called when a region's task finishes and when each of its nested regions finishes. Whoever finishes last evaluates the
+// region's synthesized attributes and then does the same for the parent region.
+template <class I, class S>
+void
+AstTaskParallelTopDownBottomUpProcessing<I, S>::finishRegion(Context *context, Region *region)
+{
+    while (region != NULL)
+    {
+        {
+            boost::lock_guard<boost::mutex> lock(context->mutex);
+            if (--region->nPending > 0)
+                return;
+        }
+
+        SynthesizedAttributesList stack;
+        size_t entryIndex = 0;
+        evaluateRegion(region, entryIndex, stack);
+        region->result = stack.pop();
+        std::vector<typename Region::Entry>().swap(region->entries);
+        region = region->parent;
+    }
+}
+
 #endif
@@ -139,8 +139,15 @@ protected:
     size_t nbits;               /**< Number of significant bits. Constant over the life of the node. */
     mutable std::string comment; /**< Optional comment. Only for debugging; not significant for any calculation. */
     mutable uint64_t hashval;   /**< Optional hash used as a quick way to indicate that two expressions are different. */
+    mutable bool interned;      /**< True if this node was ever added to the HashConsing table and therefore may be shared. */
+
+    // Returns a new, unshared node that is equal to this one except for its comment.
+    virtual TreeNodePtr copy_with_comment(const std::string&) const = 0;
+
+    friend class HashConsing;                   // sets the interned flag
 public:
-    TreeNode(size_t nbits, std::string comment=""): nbits(nbits), comment(comment), hashval(0) { ASSERT_require(nbits>0); }
+    TreeNode(size_t nbits, std::string comment="")
+        : nbits(nbits), comment(comment), hashval(0), interned(false) { ASSERT_require(nbits>0); }
 
     /** Returns true if two expressions must be equal (cannot be unequal).  If an SMT solver is specified then that solver is
      * used to answer this question, otherwise equality is established by looking only at the structure of the two
@@ -179,11 +186,26 @@ public:
     /** Accessors for the comment string associated with a node. Comments can be changed after a node has been created since
      *  the comment is not intended to be used for anything but annotation and/or debugging. I.e., comments are not
      *  considered significant for comparisons, computing hash values, etc.
+     *
+     *  A node that is shared by @ref HashConsing (see @ref is_interned) is used by unrelated expressions and its comment must
+     *  not be changed; use @ref commented instead.
      * @{ */
     const std::string& get_comment() const { return comment; }
-    void set_comment(const std::string &s) const { comment=s; }
+    void set_comment(const std::string &s) const {
+        ASSERT_forbid2(interned && s!=comment, "comment of a hash-consed node cannot be changed; use commented()");
+        comment=s;
+    }
     /** @} */
 
+    /** Returns an expression with the specified comment.
+     *
+     *  If this node is shared by @ref HashConsing then a new node that differs from this one only in its comment is returned
+     *  and this node is not changed. Otherwise this node's comment is changed and this node is returned. */
+    TreeNodePtr commented(const std::string&) const;
+
+    /** True if this node may be shared by @ref HashConsing. Such nodes are never modified. */
+    bool is_interned() const { return interned; }
+
     /** Returns the number of significant bits.  An expression with a known value is guaranteed to have all higher-order bits
      *  cleared. */
     size_t get_nbits() const { return nbits; }
@@ -226,7 +248,9 @@ public:
     bool is_hashed() const { return hashval!=0; }
 
     /** Returns (and caches) the hash value for this node.  If a hash value is not cached in this node, then a new hash value
-     *  is computed and cached. */
+     *  is computed and cached.  The hash of an internal node is computed from its operator, width, and the hashes of its
+     *  children, so hashing a new node whose children are already hashed takes time proportional to the number of
+     *  children. */
     uint64_t hash() const;
 
     /** A node with formatter. See the with_format() method. */
@@ -442,28 +466,30 @@ public:
     /** Create a new expression node. Although we're creating internal nodes, the simplification process might replace it with
      *  a leaf node. Use these class methods instead of c'tors.
      *
+     *  If @ref HashConsing is enabled then the returned node might be shared with other expressions.
+     *
      *  @{ */
     static TreeNodePtr create(size_t nbits, Operator op, const std::string comment="") {
         InternalNodePtr retval(new InternalNode(nbits, op, comment));
-        return retval->simplifyTop();
+        return createSimplified(retval);
     }
     static TreeNodePtr create(size_t nbits, Operator op, const TreeNodePtr &a, const std::string comment="") {
         InternalNodePtr retval(new InternalNode(nbits, op, a, comment));
-        return retval->simplifyTop();
+        return createSimplified(retval);
     }
     static TreeNodePtr create(size_t nbits, Operator op, const TreeNodePtr &a, const TreeNodePtr &b,
                                   const std::string comment="") {
         InternalNodePtr retval(new InternalNode(nbits, op, a, b, comment));
-        return retval->simplifyTop();
+        return createSimplified(retval);
     }
     static TreeNodePtr create(size_t nbits, Operator op, const TreeNodePtr &a, const TreeNodePtr &b, const TreeNodePtr &c,
                                   const std::string comment="") {
         InternalNodePtr retval(new InternalNode(nbits, op, a, b, c, comment));
-        return retval->simplifyTop();
+        return createSimplified(retval);
     }
     static TreeNodePtr create(size_t nbits, Operator op, const TreeNodes &children, const std::string comment="") {
         InternalNodePtr retval(new InternalNode(nbits, op, children, comment));
-        return retval->simplifyTop();
+        return createSimplified(retval);
     }
     /** @} */
 
@@ -532,7 +558,13 @@ public:
     // documented in super class
     virtual void print(std::ostream&, Formatter&) const ROSE_OVERRIDE;
 
+private:
+    // Simplifies a newly constructed node, consulting and updating the hash-consing tables if they're enabled.
+    static TreeNodePtr createSimplified(const InternalNodePtr&);
+
 protected:
+    virtual TreeNodePtr copy_with_comment(const std::string&) const ROSE_OVERRIDE;
+
     /** Appends @p child as a new child of this node. The modification is done in place, so one must be careful that this node
      *  is not part of other expressions.  It is safe to call add_child() on a node that was just created and not used anywhere
      *  yet. */
@@ -554,6 +586,9 @@ private:
 
     static uint64_t name_counter;
 
+protected:
+    virtual TreeNodePtr copy_with_comment(const std::string&) const ROSE_OVERRIDE;
+
 public:
     /** Construct a new free variable with a specified number of significant bits. */
     static LeafNodePtr create_variable(size_t nbits, std::string comment="");
@@ -605,6 +640,86 @@ public:
     }
 };
 
+/** Hash-consing of expressions.
+ *
+ *  When enabled, structurally equivalent expressions returned by @ref InternalNode::create, @ref LeafNode::create_integer, and
+ *  @ref LeafNode::create_constant are represented by a single shared node, and the result of simplifying each combination of
+ *  operator, width, and children is remembered so that building the same expression a second time doesn't run the
+ *  simplifier again.  Symbolic execution of long instruction traces tends to build the same expressions over and over (flag
+ *  computations, address arithmetic, etc.) and hash-consing reduces both the time spent in the simplifier and the memory used
+ *  by duplicate trees.
+ *
+ *  Nodes that have comments are never shared since comments are not part of an expression's identity.  Conversely, a shared
+ *  node's comment cannot be changed with @ref TreeNode::set_comment; @ref TreeNode::commented returns an unshared copy
+ *  that has the comment instead.
+ *
+ *  The tables hold references to the nodes they contain, so those nodes are not deleted until the tables are cleared, which
+ *  happens explicitly with @ref clear or automatically when the tables exceed @ref maxSize entries.  Clearing the tables
+ *  never changes the value of any expression; it only means that subsequently created expressions might not share nodes with
+ *  expressions created before the clear.
+ *
+ *  Hash-consing is disabled by default.
+ *
+ *  Thread safety: Not thread safe, but neither are the reference counts of the expression nodes themselves. */
+class HashConsing {
+public:
+    /** Counters for the hash-consing tables. */
+    struct Statistics {
+        size_t nInternHits;                             /**< Number of times an existing equivalent node was returned. */
+        size_t nInternMisses;                           /**< Number of nodes that were added to the table. */
+        size_t nSimplifyHits;                           /**< Number of times simplification was skipped. */
+        size_t nSimplifyMisses;                         /**< Number of times the simplifier had to run. */
+        size_t nClears;                                 /**< Number of times the tables were cleared. */
+        Statistics(): nInternHits(0), nInternMisses(0), nSimplifyHits(0), nSimplifyMisses(0), nClears(0) {}
+    };
+
+    /** Property: whether hash-consing is enabled.
+     *
+     *  Disabling hash-consing also clears the tables.
+     *
+     * @{ */
+    static bool enabled();
+    static void enabled(bool);
+    /** @} */
+
+    /** Property: maximum number of table entries.
+     *
+     *  When the number of entries exceeds this value the tables are cleared. The default is one million.
+     *
+     * @{ */
+    static size_t maxSize();
+    static void maxSize(size_t);
+    /** @} */
+
+    /** Number of entries in the tables. */
+    static size_t size();
+
+    /** Remove all entries from the tables. */
+    static void clear();
+
+    /** Statistics since the last reset.
+     *
+     * @{ */
+    static Statistics statistics();
+    static void resetStatistics();
+    /** @} */
+
+    /** Return the shared node equivalent to the specified expression.
+     *
+     *  If hash-consing is enabled and the expression has no comment then returns the node in the table that is structurally
+     *  equivalent to @p expr, adding @p expr to the table if there is none.  Otherwise @p expr is returned. */
+    static TreeNodePtr intern(const TreeNodePtr &expr);
+
+private:
+    friend class InternalNode;
+
+    // Previously computed simplification of a node having the same operator, width, and children (by identity), or null.
+    static TreeNodePtr findSimplified(const InternalNodePtr &unsimplified);
+
+    // Remember the result of simplifying a node.
+    static void insertSimplified(const InternalNodePtr &unsimplified, const TreeNodePtr &simplified);
+};
+
 std::ostream& operator<<(std::ostream &o, const TreeNode&);
 std::ostream& operator<<(std::ostream &o, const TreeNode::WithFormatter&);
 
@@ -17,7 +17,15 @@ namespace BinaryAnalysis {
  *
  *  The purpose of an SMT solver is to determine if an expression is satisfiable. Although the SMTSolver class was originally
  *  designed to be used by SymbolicExpressionSemantics policy (see SymbolicExpressionSemantics::Policy::set_solver()), but it
- *  can also be used independently. */
+ *  can also be used independently.
+ *
+ *  A solver can be used in two ways.  The @ref satisfiable methods answer one self-contained question per call, which for
+ *  most solvers means generating an input file and running the solver executable on it.  The incremental interface (@ref
+ *  push, @ref pop, @ref insert, and @ref check) instead maintains a stack of assertion levels so that related questions can
+ *  share assertions.  Solvers that support it (see @ref get_interactive_command) answer both kinds of questions with one
+ *  long-lived solver process per SMTSolver object, sending only the commands that changed since the previous check; other
+ *  solvers answer each @ref satisfiable question by running the solver on an input file, and incremental questions by
+ *  calling @ref satisfiable with all the current assertions. */
 class SMTSolver {
 public:
     struct Exception {
@@ -34,17 +42,27 @@ public:
 
     /** SMT solver statistics. */
     struct Stats {
-        Stats(): ncalls(0), input_size(0), output_size(0) {}
+        Stats(): ncalls(0), input_size(0), output_size(0), ncache_hits(0), ncache_misses(0) {}
         size_t ncalls;                          /**< Number of times satisfiable() was called. */
         size_t input_size;                      /**< Bytes of input generated for satisfiable(). */
         size_t output_size;                     /**< Amount of output produced by the SMT solver. */
+        size_t ncache_hits;                     /**< Number of queries answered by the query cache. */
+        size_t ncache_misses;                   /**< Number of queries the query cache could not answer. */
     };
 
     typedef std::set<uint64_t> Definitions;     /**< Free variables that have been defined. */
 
-    SMTSolver(): debug(NULL) { init(); }
+    SMTSolver(): debug(NULL), coprocess(NULL), use_cache(false) { init(); }
+
+    /** Copy constructor.  The copy has the same assertions and cached results but does not share the original's solver
+     *  process. */
+    SMTSolver(const SMTSolver &other)
+        : output_text(other.output_text), stats(other.stats), debug(other.debug), levels(other.levels), coprocess(NULL),
+          use_cache(other.use_cache), cache(other.cache) {}
 
-    virtual ~SMTSolver() {}
+    virtual ~SMTSolver();
+
+    SMTSolver& operator=(const SMTSolver&);
 
     /** Determines if expressions are trivially satisfiable or unsatisfiable.  If all expressions are known 1-bit values that
      *  are true, then this function returns SAT_YES.  If any expression is a known 1-bit value that is false, then this
@@ -52,13 +70,43 @@ public:
     virtual Satisfiable trivially_satisfiable(const std::vector<InsnSemanticsExpr::TreeNodePtr> &exprs);
 
     /** Determines if the specified expressions are all satisfiable, unsatisfiable, or unknown.
+     *
+     *  The answer does not depend on the assertions of the incremental interface.  If the solver has a long-lived process
+     *  (see @ref get_interactive_command) then the question is asked in a new assertion level of that process, which is popped
+     *  afterward; otherwise the solver is run on an input file generated for this question alone.
      * @{ */
     virtual Satisfiable satisfiable(const InsnSemanticsExpr::TreeNodePtr&);
     virtual Satisfiable satisfiable(const std::vector<InsnSemanticsExpr::TreeNodePtr>&);
     virtual Satisfiable satisfiable(std::vector<InsnSemanticsExpr::TreeNodePtr>, const InsnSemanticsExpr::TreeNodePtr&);
     /** @} */
 
+    /** Create a new assertion level.
+     *
+     *  Assertions inserted after a push are removed by the matching @ref pop.  A new solver has one level, which cannot be
+     *  popped. */
+    virtual void push();
+
+    /** Remove the most recent assertion level and all its assertions. */
+    virtual void pop();
+
+    /** Number of assertion levels.  This is always at least one. */
+    size_t nlevels() const { return levels.size(); }
+
+    /** Add an assertion to the current level.  The expression must be a Boolean (1-bit) expression. */
+    virtual void insert(const InsnSemanticsExpr::TreeNodePtr&);
+
+    /** All current assertions from all levels, oldest first. */
+    std::vector<InsnSemanticsExpr::TreeNodePtr> get_assertions() const;
+
+    /** Remove all assertions and all levels except the first.  This also terminates the solver process if there is one. */
+    virtual void reset();
 
+    /** Determines whether the current assertions are satisfiable.
+     *
+     *  If the solver supports a long-lived process (@ref get_interactive_command returns a non-empty string) then the process
+     *  is started if necessary, given any assertion level changes since the previous check, and asked for an answer, and
+     *  evidence is parsed from its reply.  Otherwise this is the same as calling @ref satisfiable with @ref get_assertions. */
+    virtual Satisfiable check();
 
     /** Evidence of satisfiability for a bitvector variable.  If an expression is satisfiable, this function will return
      *  a value for the specified bitvector variable that satisfies the expression in conjunction with the other evidence. Not
@@ -99,6 +147,40 @@ public:
     /** Clears evidence information. */
     virtual void clear_evidence() {}
 
+    /** Property: whether query results are cached.
+     *
+     *  When enabled, the answer to each non-trivial query (@ref satisfiable or @ref check) is remembered along with its
+     *  evidence, and a later query whose expressions are the same up to a consistent renaming of free variables and memory
+     *  states is answered from the cache without running the solver.  Evidence restored from the cache is renamed to the
+     *  variables of the new query.  Queries are identified by a 128-bit hash of their canonical form rather than by the
+     *  expressions themselves so that the cache is small and can be saved to a file; a false hit therefore requires a
+     *  collision of both 64-bit halves.  The cache is disabled by default.
+     *
+     *  Hits and misses are counted in the @ref Stats. Subclasses that produce evidence must implement @ref set_evidence for
+     *  cached answers to include it.
+     * @{ */
+    void set_use_cache(bool b) { use_cache = b; }
+    bool get_use_cache() const { return use_cache; }
+    /** @} */
+
+    /** Number of queries in the cache. */
+    size_t cache_size() const { return cache.size(); }
+
+    /** Forget all cached query results. */
+    void clear_cache() { cache.clear(); }
+
+    /** Write the cached query results to a file.
+     *
+     *  The file is text and can be read by @ref load_cache, possibly in a later run of the program, since it depends only on
+     *  the expressions and not on variable numbering.  Throws an Exception if the file cannot be written. */
+    void save_cache(const std::string &filename) const;
+
+    /** Add cached query results from a file.
+     *
+     *  Reads a file written by @ref save_cache and adds its results to this solver's cache.  Entries already in the cache are
+     *  not replaced.  Throws an Exception if the file cannot be opened or is not a query cache. */
+    void load_cache(const std::string &filename);
+
     /** Turns debugging on or off. */
     void set_debug(FILE *f) { debug = f; }
 
@@ -130,6 +212,56 @@ protected:
      *  expression.  This information is parsed by this function and added to a mapping of variable to value. */
     virtual void parse_evidence() {};
 
+    /** Command that starts a long-lived solver process for the incremental interface.
+     *
+     *  The process reads commands from its standard input and writes replies to its standard output.  Returns an empty string
+     *  (the default) if the solver has no such mode, in which case the incremental interface is implemented by calling @ref
+     *  satisfiable.  Subclasses that return a command must also implement the other generate_interactive_* methods. */
+    virtual std::string get_interactive_command() { return ""; }
+
+    /** Prompt that the solver process prints before its replies, if any.  It is removed from the beginning of each line. */
+    virtual std::string get_interactive_prompt() { return ""; }
+
+    /** Generates solver input for the incremental interface.
+     *
+     *  These write the text that creates an assertion level, removes an assertion level, defines any free variables not
+     *  already in @p defns (adding them) and asserts an expression, and checks satisfiability.  The check command must be
+     *  followed by something that makes the solver print @p end_marker on a line by itself after its reply so the reply's
+     *  end can be found.
+     *
+     * @{ */
+    virtual void generate_interactive_push(std::ostream&) {}
+    virtual void generate_interactive_pop(std::ostream&) {}
+    virtual void generate_interactive_assert(std::ostream&, const InsnSemanticsExpr::TreeNodePtr&, Definitions *defns) {}
+    virtual void generate_interactive_check(std::ostream&, const std::string &end_marker) {}
+    /** @} */
+
+    /** Restores one item of evidence.  Called when a satisfiable query is answered from the query cache, with a name like
+     *  those returned by evidence_names().  The default does nothing, in which case cached answers have no evidence. */
+    virtual void set_evidence(const std::string &name, const InsnSemanticsExpr::TreeNodePtr &value) {}
+
+    /** Identifies a query in the query cache.  The hash is computed over a canonical form of the expressions in which free
+     *  variables are numbered in the order they're first encountered, and @p variables maps those numbers back to the
+     *  query's own variable names. */
+    struct QueryKey {
+        std::pair<uint64_t, uint64_t> hash;
+        std::vector<uint64_t> variables;        /**< Bitvector variable name for each canonical variable number. */
+        bool valid;                             /**< False when the cache is disabled. */
+        QueryKey(): hash(0, 0), valid(false) {}
+    };
+
+    /** Looks up a query in the query cache.
+     *
+     *  If the cache is enabled, computes the query's key and returns true if a result was found, in which case the result is
+     *  returned in @p result and its evidence is restored with @ref set_evidence.  Subclasses that override @ref satisfiable
+     *  call this after checking for trivial satisfiability and pass @p key to @ref cache_insert after a miss. */
+    bool cache_lookup(const std::vector<InsnSemanticsExpr::TreeNodePtr> &exprs, QueryKey &key /*out*/,
+                      Satisfiable &result /*out*/);
+
+    /** Saves the result of a query that was not in the cache, along with its current evidence.  Does nothing if the key is
+     *  not valid. */
+    void cache_insert(const QueryKey&, Satisfiable);
+
     /** Additional output obtained by satisfiable(). */
     std::string output_text;
 
@@ -140,7 +272,39 @@ protected:
 
 private:
     FILE *debug;
+
+    // Assertions for the incremental interface. There is always at least one level.
+    typedef std::vector<InsnSemanticsExpr::TreeNodePtr> Assertions;
+    std::vector<Assertions> levels;
+
+    // Long-lived solver process for the incremental interface, and how much of "levels" it has been told about.
+    struct Coprocess;
+    Coprocess *coprocess;
+
+    // Query result cache indexed by QueryKey::hash. Evidence for bitvector variables is stored by canonical variable number
+    // (plus one), and other evidence (memory addresses) by name with a zero variable number.
+    struct CachedEvidence {
+        std::string name;
+        size_t variable;
+        size_t nbits;
+        uint64_t value;
+        CachedEvidence(): variable(0), nbits(0), value(0) {}
+    };
+    struct CachedResult {
+        Satisfiable sat;
+        std::vector<CachedEvidence> evidence;
+        CachedResult(): sat(SAT_UNKNOWN) {}
+    };
+    typedef std::map<std::pair<uint64_t, uint64_t>, CachedResult> QueryCache;
+    bool use_cache;
+    QueryCache cache;
+
     void init();
+    void start_coprocess();
+    void stop_coprocess();
+    void pop_coprocess(size_t n);
+    void send_to_coprocess(const std::string&);
+    bool read_from_coprocess(std::string &line /*out*/);
 };
 
 } // namespace
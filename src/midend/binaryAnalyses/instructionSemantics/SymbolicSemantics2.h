@@ -129,8 +129,9 @@ public:
  */
 class SValue: public BaseSemantics::SValue {
 protected:
-    /** The symbolic expression for this value.  Symbolic expressions are reference counted. */
-    TreeNodePtr expr;
+    /** The symbolic expression for this value.  Symbolic expressions are reference counted.  This is mutable only so that
+     *  set_comment() can replace a shared expression with a commented copy, which doesn't change the value. */
+    mutable TreeNodePtr expr;
 
     /** Instructions defining this value.  Any instruction that saves the value to a register or memory location
      *  adds itself to the saved value. */
@@ -175,7 +176,7 @@ public:
     }
     virtual BaseSemantics::SValuePtr boolean_(bool value) const ROSE_OVERRIDE {
         SValuePtr result = SValue::promote(number_(1, value?1:0));
-        result->get_expression()->set_comment(value?"true":"false");
+        result->set_comment(value?"true":"false");
         return result;
     }
     virtual BaseSemantics::SValuePtr copy(size_t new_width=0) const ROSE_OVERRIDE {
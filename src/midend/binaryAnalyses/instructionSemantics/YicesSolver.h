@@ -17,6 +17,11 @@ namespace BinaryAnalysis {
  *
  *  Yices provides two interfaces: an executable named "yices", and a library. The choice of which linkage to use to answer
  *  satisfiability questions is made at runtime (see set_linkage()).
+ *
+ *  When using the executable, the incremental interface (SMTSolver::push, SMTSolver::pop, SMTSolver::insert, and
+ *  SMTSolver::check) runs one interactive "yices" process per solver object and reuses its assertions across checks with
+ *  Yices' own push and pop commands.  Yices definitions are global rather than scoped, so each free variable is defined only
+ *  once per process.
  */
 class YicesSolver: public SMTSolver {
 public:
@@ -68,6 +73,15 @@ public:
     virtual void clear_evidence() /*overrides*/;
 
 protected:
+    virtual std::string get_interactive_command() ROSE_OVERRIDE;
+    virtual std::string get_interactive_prompt() ROSE_OVERRIDE;
+    virtual void generate_interactive_push(std::ostream&) ROSE_OVERRIDE;
+    virtual void generate_interactive_pop(std::ostream&) ROSE_OVERRIDE;
+    virtual void generate_interactive_assert(std::ostream&, const InsnSemanticsExpr::TreeNodePtr&,
+                                             Definitions*) ROSE_OVERRIDE;
+    virtual void generate_interactive_check(std::ostream&, const std::string &end_marker) ROSE_OVERRIDE;
+    virtual void set_evidence(const std::string &name, const InsnSemanticsExpr::TreeNodePtr &value) ROSE_OVERRIDE;
+
     virtual uint64_t parse_variable(const char *nptr, char **endptr, char first_char);
     virtual void parse_evidence();
     typedef std::map<std::string/*name or hex-addr*/, std::pair<size_t/*nbits*/, uint64_t/*value*/> > Evidence;
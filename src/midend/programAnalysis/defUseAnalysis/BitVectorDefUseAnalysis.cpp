@@ -0,0 +1,449 @@
+/******************************************
+ * Category: DFA
+ * Bit vector DefUse Analysis Definition
+ *****************************************/
+#include "sage3basic.h"
+#include "BitVectorDefUseAnalysis.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/**********************************************************
+ * Order sites by variable, keeping the order in which
+ * they were found for the sites of the same variable
+ *********************************************************/
+namespace {
+  template <class SiteT>
+  struct LessVariable {
+    bool operator()(const SiteT& a, const SiteT& b) const {
+      return a.var < b.var;
+    }
+  };
+}
+
+BitVectorDefUseAnalysisPF::BitVectorDefUseAnalysisPF(SgFunctionDefinition* function,
+                                                     const vector<SgInitializedName*>& globals)
+  : function(function), cfg(FilteredCFGNode<IsDFAFilter>(function->cfgForBeginning())),
+    nrOfNodesVisited(0) {
+  vector<Site> defSites, useSites;
+  collectSites(globals, defSites, useSites);
+  numberSites(defSites, defs, defRanges);
+  numberSites(useSites, uses, useRanges);
+
+  // both definitions and uses are killed by the definitions that replace a variable
+  Transfer defTransfer, useTransfer;
+  buildTransfer(defSites, defSites, defTransfer);
+  buildTransfer(useSites, defSites, useTransfer);
+
+  solve(defTransfer, defRanges, defs.size(), defsOut);
+  solve(useTransfer, useRanges, uses.size(), usesOut);
+}
+
+/**********************************************************
+ * Dense number of a variable
+ *********************************************************/
+size_t BitVectorDefUseAnalysisPF::getVariable(SgInitializedName* var) {
+  boost::unordered_map<SgInitializedName*, size_t>::iterator i = varIds.find(var);
+  if (i != varIds.end())
+    return i->second;
+  varIds[var] = vars.size();
+  vars.push_back(var);
+  return vars.size() - 1;
+}
+
+void BitVectorDefUseAnalysisPF::addDefinition(vector<Site>& sites, SgInitializedName* var,
+                                              SgNode* node, NodeId n, bool kills) {
+  ROSE_ASSERT(var);
+  Site site;
+  site.var = getVariable(var);
+  site.node = node;
+  site.cfgNode = n;
+  site.kills = kills;
+  site.bit = 0;
+  sites.push_back(site);
+}
+
+/**********************************************************
+ * Scan the CFG for definitions and uses. The rules are the
+ * ones of DefUseAnalysisPF::defuse; each AST node is handled
+ * at its last CFG node, except the function entry where
+ * the global variables are defined.
+ * Assignments to array elements and &var arguments of calls
+ * are weak definitions: they do not kill the other definitions.
+ *********************************************************/
+void BitVectorDefUseAnalysisPF::collectSites(const vector<SgInitializedName*>& globals,
+                                             vector<Site>& defSites, vector<Site>& useSites) {
+  for (NodeId n = 0; n < cfg.size(); ++n) {
+    SgNode* sgNode = cfg.getNode(n);
+    boost::unordered_map<SgNode*, NodeId>::iterator last = lastCFGNode.find(sgNode);
+    if (last == lastCFGNode.end() || cfg.getIndex(last->second) < cfg.getIndex(n))
+      lastCFGNode[sgNode] = n;
+  }
+
+  for (NodeId n = 0; n < cfg.size(); ++n) {
+    SgNode* sgNode = cfg.getNode(n);
+    if (n == cfg.getEntry()) {
+      for (vector<SgInitializedName*>::const_iterator g = globals.begin(); g != globals.end(); ++g)
+        addDefinition(defSites, *g, *g, n, true);
+      continue;
+    }
+    if (lastCFGNode[sgNode] != n)
+      continue;
+
+    if (isSgUnaryOp(sgNode)) {
+      SgUnaryOp* unary = isSgUnaryOp(sgNode);
+      if (!isSgPlusPlusOp(unary) && !isSgMinusMinusOp(unary))
+        continue;
+      SgExpression* l_expr = unary->get_operand();
+      if (isSgAssignOp(l_expr)) {
+        // (t=i)++ : the first varRefExp of the operand
+        Rose_STL_Container<SgNode*> refs = NodeQuery::querySubTree(l_expr, V_SgVarRefExp);
+        if (refs.size() > 0)
+          l_expr = isSgVarRefExp(*refs.begin());
+      }
+      if (isSgVarRefExp(l_expr))
+        addDefinition(defSites, isSgVarRefExp(l_expr)->get_symbol()->get_declaration(), sgNode, n, true);
+    }
+
+    else if (isSgBinaryOp(sgNode)) {
+      SgBinaryOp* binary = isSgBinaryOp(sgNode);
+      switch (binary->variantT()) {
+      case V_SgAssignOp:
+      case V_SgModAssignOp:
+      case V_SgDivAssignOp:
+      case V_SgMultAssignOp:
+      case V_SgLshiftAssignOp:
+      case V_SgRshiftAssignOp:
+      case V_SgXorAssignOp:
+      case V_SgAndAssignOp:
+      case V_SgMinusAssignOp:
+      case V_SgPlusAssignOp:
+        break;
+      default:
+        continue;
+      }
+      SgExpression* l_expr = binary->get_lhs_operand();
+      if (isSgVarRefExp(l_expr)) {
+        addDefinition(defSites, isSgVarRefExp(l_expr)->get_symbol()->get_declaration(), sgNode, n, true);
+      } else if (isSgPntrArrRefExp(l_expr)) {
+        SgPntrArrRefExp* array = isSgPntrArrRefExp(l_expr);
+        while (isSgPntrArrRefExp(array->get_lhs_operand()))
+          array = isSgPntrArrRefExp(array->get_lhs_operand());
+        SgVarRefExp* varRefExp = isSgVarRefExp(array->get_lhs_operand());
+        if (varRefExp == NULL) {
+          Rose_STL_Container<SgNode*> refs = NodeQuery::querySubTree(array, V_SgVarRefExp);
+          if (refs.size() > 0)
+            varRefExp = isSgVarRefExp(*refs.begin());
+        }
+        if (varRefExp)
+          addDefinition(defSites, varRefExp->get_symbol()->get_declaration(), sgNode, n, false);
+      }
+    }
+
+    else if (isSgAssignInitializer(sgNode)) {
+      SgInitializedName* initName = isSgInitializedName(sgNode->get_parent());
+      if (initName)
+        addDefinition(defSites, initName, sgNode, n, true);
+    }
+
+    else if (isSgInitializedName(sgNode)) {
+      addDefinition(defSites, isSgInitializedName(sgNode), sgNode, n, true);
+    }
+
+    else if (isSgVarRefExp(sgNode)) {
+      // a use, unless the variable is assigned to
+      SgVarRefExp* varRefExp = isSgVarRefExp(sgNode);
+      SgNode* parent = varRefExp->get_parent();
+      ROSE_ASSERT(parent);
+      SgPntrArrRefExp* array = isSgPntrArrRefExp(parent);
+      SgNode* parentsparent = parent->get_parent();
+      if ((isSgAssignOp(parent) && isSgAssignOp(parent)->get_lhs_operand() == varRefExp) ||
+          (array && array->get_lhs_operand() == varRefExp &&
+           isSgAssignOp(parentsparent) && isSgAssignOp(parentsparent)->get_lhs_operand() == array))
+        continue;
+      SgInitializedName* initName = varRefExp->get_symbol()->get_declaration();
+      ROSE_ASSERT(initName);
+      Site site;
+      site.var = getVariable(initName);
+      site.node = sgNode;
+      site.cfgNode = n;
+      site.kills = false;
+      site.bit = 0;
+      useSites.push_back(site);
+    }
+
+    else if (isSgFunctionCallExp(sgNode)) {
+      SgExpressionPtrList& args = isSgFunctionCallExp(sgNode)->get_args()->get_expressions();
+      for (SgExpressionPtrList::iterator i = args.begin(); i != args.end(); ++i) {
+        SgExpression* expr = *i;
+        if (isSgCastExp(expr))
+          expr = isSgCastExp(expr)->get_operand();
+        if (isSgAddressOfOp(expr) && isSgVarRefExp(isSgAddressOfOp(expr)->get_operand())) {
+          SgVarRefExp* varRefExp = isSgVarRefExp(isSgAddressOfOp(expr)->get_operand());
+          addDefinition(defSites, varRefExp->get_symbol()->get_declaration(), sgNode, n, false);
+        }
+      }
+    }
+  }
+}
+
+/**********************************************************
+ * Number the sites by variable; a site found twice (e.g.
+ * f(&x, &x)) gets one bit
+ *********************************************************/
+void BitVectorDefUseAnalysisPF::numberSites(vector<Site>& sites, vector<SiteType>& numbered,
+                                            vector<BitRange>& ranges) {
+  stable_sort(sites.begin(), sites.end(), LessVariable<Site>());
+  numbered.clear();
+  ranges.assign(vars.size(), BitRange());
+  for (size_t i = 0; i < sites.size(); ++i) {
+    Site& site = sites[i];
+    if (i > 0 && sites[i - 1].var == site.var && sites[i - 1].node == site.node) {
+      site.bit = sites[i - 1].bit;
+      continue;
+    }
+    site.bit = numbered.size();
+    numbered.push_back(SiteType(vars[site.var], site.node));
+    if (ranges[site.var].isEmpty())
+      ranges[site.var] = BitRange::baseSize(site.bit, 1);
+    else
+      ranges[site.var] = BitRange::hull(ranges[site.var].least(), site.bit);
+  }
+}
+
+/**********************************************************
+ * Gen and kill sets of all CFG nodes
+ *********************************************************/
+void BitVectorDefUseAnalysisPF::buildTransfer(const vector<Site>& genSites,
+                                              const vector<Site>& killSites,
+                                              Transfer& transfer) const {
+  // count, then fill (as the edges of FlatCFG)
+  transfer.genOffsets.assign(cfg.size() + 1, 0);
+  transfer.killOffsets.assign(cfg.size() + 1, 0);
+  for (vector<Site>::const_iterator i = genSites.begin(); i != genSites.end(); ++i)
+    ++transfer.genOffsets[i->cfgNode + 1];
+  for (vector<Site>::const_iterator i = killSites.begin(); i != killSites.end(); ++i)
+    if (i->kills)
+      ++transfer.killOffsets[i->cfgNode + 1];
+  for (size_t n = 0; n < cfg.size(); ++n) {
+    transfer.genOffsets[n + 1] += transfer.genOffsets[n];
+    transfer.killOffsets[n + 1] += transfer.killOffsets[n];
+  }
+
+  transfer.gen.resize(transfer.genOffsets[cfg.size()]);
+  transfer.kill.resize(transfer.killOffsets[cfg.size()]);
+  vector<size_t> genNext(transfer.genOffsets.begin(), transfer.genOffsets.end() - 1);
+  vector<size_t> killNext(transfer.killOffsets.begin(), transfer.killOffsets.end() - 1);
+  for (vector<Site>::const_iterator i = genSites.begin(); i != genSites.end(); ++i)
+    transfer.gen[genNext[i->cfgNode]++] = i->bit;
+  for (vector<Site>::const_iterator i = killSites.begin(); i != killSites.end(); ++i)
+    if (i->kills)
+      transfer.kill[killNext[i->cfgNode]++] = i->var;
+}
+
+/**********************************************************
+ * Forward union analysis: out(n) = gen(n) | (in(n) & ~kill(n))
+ * with in(n) the union of out(p) for the predecessors p.
+ * The nodes are visited in id (reverse post) order, as long
+ * as the out set of one of their predecessors changed.
+ *********************************************************/
+void BitVectorDefUseAnalysisPF::solve(const Transfer& transfer, const vector<BitRange>& ranges,
+                                      size_t nbits, vector<BitVector>& out) {
+  out.assign(cfg.size(), BitVector(nbits));
+  if (nbits == 0)
+    return;
+
+  vector<bool> dirty(cfg.size(), true);
+  BitVector in(nbits);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (NodeId n = 0; n < cfg.size(); ++n) {
+      if (!dirty[n])
+        continue;
+      dirty[n] = false;
+      nrOfNodesVisited++;
+
+      in.clear();
+      for (StaticCFG::FlatCFG::const_iterator p = cfg.predBegin(n); p != cfg.predEnd(n); ++p)
+        in.bitwiseOr(out[*p]);
+      for (size_t k = transfer.killOffsets[n]; k < transfer.killOffsets[n + 1]; ++k)
+        in.clear(ranges[transfer.kill[k]]);
+      for (size_t g = transfer.genOffsets[n]; g < transfer.genOffsets[n + 1]; ++g)
+        in.set(BitRange::baseSize(transfer.gen[g], 1));
+
+      if (in.compare(out[n]) != 0) {
+        out[n] = in;
+        for (StaticCFG::FlatCFG::const_iterator s = cfg.succBegin(n); s != cfg.succEnd(n); ++s)
+          dirty[*s] = true;
+        changed = true;
+      }
+    }
+  }
+}
+
+BitVectorDefUseAnalysisPF::NodeId BitVectorDefUseAnalysisPF::getLastCFGNode(SgNode* node) const {
+  boost::unordered_map<SgNode*, NodeId>::const_iterator i = lastCFGNode.find(node);
+  return i == lastCFGNode.end() ? StaticCFG::FlatCFG::invalidId : i->second;
+}
+
+BitVectorDefUseAnalysisPF::BitRange BitVectorDefUseAnalysisPF::getDefinitionsOf(SgInitializedName* var) const {
+  boost::unordered_map<SgInitializedName*, size_t>::const_iterator i = varIds.find(var);
+  return i == varIds.end() ? BitRange() : defRanges[i->second];
+}
+
+BitVectorDefUseAnalysisPF::BitRange BitVectorDefUseAnalysisPF::getUsesOf(SgInitializedName* var) const {
+  boost::unordered_map<SgInitializedName*, size_t>::const_iterator i = varIds.find(var);
+  return i == varIds.end() ? BitRange() : useRanges[i->second];
+}
+
+const BitVectorDefUseAnalysisPF::BitVector*
+BitVectorDefUseAnalysisPF::getReachingDefinitions(SgNode* node) const {
+  NodeId n = getLastCFGNode(node);
+  return n == StaticCFG::FlatCFG::invalidId ? NULL : &defsOut[n];
+}
+
+const BitVectorDefUseAnalysisPF::BitVector*
+BitVectorDefUseAnalysisPF::getReachingUses(SgNode* node) const {
+  NodeId n = getLastCFGNode(node);
+  return n == StaticCFG::FlatCFG::invalidId ? NULL : &usesOut[n];
+}
+
+/**********************************************************
+ * Append the sites of var that are set in the out set of
+ * node; only the bits of var are scanned
+ *********************************************************/
+size_t BitVectorDefUseAnalysisPF::appendSites(SgNode* node, SgInitializedName* var,
+                                              const vector<BitVector>& out,
+                                              const vector<SiteType>& sites,
+                                              const vector<BitRange>& ranges,
+                                              vector<SgNode*>& result) const {
+  NodeId n = getLastCFGNode(node);
+  boost::unordered_map<SgInitializedName*, size_t>::const_iterator v = varIds.find(var);
+  if (n == StaticCFG::FlatCFG::invalidId || v == varIds.end() || ranges[v->second].isEmpty())
+    return 0;
+
+  const BitRange& range = ranges[v->second];
+  size_t added = 0;
+  size_t bit = range.least();
+  while (bit <= range.greatest() &&
+         out[n].leastSignificantSetBit(BitRange::hull(bit, range.greatest())).assignTo(bit)) {
+    result.push_back(sites[bit].second);
+    added++;
+    bit++;
+  }
+  return added;
+}
+
+size_t BitVectorDefUseAnalysisPF::getDefFor(SgNode* node, SgInitializedName* var,
+                                            vector<SgNode*>& result) const {
+  return appendSites(node, var, defsOut, defs, defRanges, result);
+}
+
+size_t BitVectorDefUseAnalysisPF::getUseFor(SgNode* node, SgInitializedName* var,
+                                            vector<SgNode*>& result) const {
+  return appendSites(node, var, usesOut, uses, useRanges, result);
+}
+
+/******************************************
+ * Project driver
+ *****************************************/
+BitVectorDefUseAnalysis::BitVectorDefUseAnalysis(SgProject* project)
+  : project(project), globalsFound(false) {
+}
+
+BitVectorDefUseAnalysis::~BitVectorDefUseAnalysis() {
+  clear();
+}
+
+void BitVectorDefUseAnalysis::clear() {
+  for (vector<BitVectorDefUseAnalysisPF*>::iterator i = functions.begin(); i != functions.end(); ++i)
+    delete *i;
+  functions.clear();
+  functionOfNode.clear();
+}
+
+/******************************************
+ * Global variables, with the same filter as
+ * GlobalVarAnalysis
+ *****************************************/
+void BitVectorDefUseAnalysis::find_all_global_variables() {
+  globalVarList.clear();
+  Rose_STL_Container<SgNode*> initNames = NodeQuery::querySubTree(project, V_SgInitializedName);
+  for (Rose_STL_Container<SgNode*>::const_iterator i = initNames.begin(); i != initNames.end(); ++i) {
+    SgInitializedName* iName = isSgInitializedName(*i);
+    Sg_File_Info* fi = iName->get_file_info();
+    if (fi->isCompilerGenerated() || fi->get_filenameString().find("/include/") != string::npos)
+      continue;
+    if (isSgGlobal(iName->get_scope()))
+      globalVarList.push_back(iName);
+  }
+  globalsFound = true;
+}
+
+int BitVectorDefUseAnalysis::run() {
+  ROSE_ASSERT(project != NULL);
+  clear();
+  find_all_global_variables();
+
+  Rose_STL_Container<SgNode*> defs = NodeQuery::querySubTree(project, V_SgFunctionDefinition);
+  for (Rose_STL_Container<SgNode*>::const_iterator i = defs.begin(); i != defs.end(); ++i) {
+    SgFunctionDefinition* proc = isSgFunctionDefinition(*i);
+    if (getFullName(proc) != "")
+      run(proc);
+  }
+  return 0;
+}
+
+const BitVectorDefUseAnalysisPF* BitVectorDefUseAnalysis::run(SgFunctionDefinition* function) {
+  ROSE_ASSERT(function);
+  if (!globalsFound)
+    find_all_global_variables();
+
+  BitVectorDefUseAnalysisPF* analysis = new BitVectorDefUseAnalysisPF(function, globalVarList);
+  vector<BitVectorDefUseAnalysisPF*>::iterator old = functions.begin();
+  for (; old != functions.end() && (*old)->getFunction() != function; ++old) {}
+  if (old != functions.end()) {
+    // forget the nodes of the old analysis, some of which may no longer be in the function
+    const StaticCFG::FlatCFG& oldCfg = (*old)->getCFG();
+    for (StaticCFG::FlatCFG::NodeId n = 0; n < oldCfg.size(); ++n) {
+      boost::unordered_map<SgNode*, BitVectorDefUseAnalysisPF*>::iterator i = functionOfNode.find(oldCfg.getNode(n));
+      if (i != functionOfNode.end() && i->second == *old)
+        functionOfNode.erase(i);
+    }
+    delete *old;
+    *old = analysis;
+  } else {
+    functions.push_back(analysis);
+  }
+
+  const StaticCFG::FlatCFG& cfg = analysis->getCFG();
+  for (StaticCFG::FlatCFG::NodeId n = 0; n < cfg.size(); ++n)
+    functionOfNode[cfg.getNode(n)] = analysis;
+  return analysis;
+}
+
+const BitVectorDefUseAnalysisPF* BitVectorDefUseAnalysis::getFunctionAnalysis(SgNode* node) const {
+  boost::unordered_map<SgNode*, BitVectorDefUseAnalysisPF*>::const_iterator i = functionOfNode.find(node);
+  return i == functionOfNode.end() ? NULL : i->second;
+}
+
+size_t BitVectorDefUseAnalysis::getDefFor(SgNode* node, SgInitializedName* var,
+                                          vector<SgNode*>& result) const {
+  const BitVectorDefUseAnalysisPF* analysis = getFunctionAnalysis(node);
+  return analysis ? analysis->getDefFor(node, var, result) : 0;
+}
+
+size_t BitVectorDefUseAnalysis::getUseFor(SgNode* node, SgInitializedName* var,
+                                          vector<SgNode*>& result) const {
+  const BitVectorDefUseAnalysisPF* analysis = getFunctionAnalysis(node);
+  return analysis ? analysis->getUseFor(node, var, result) : 0;
+}
+
+size_t BitVectorDefUseAnalysis::getNumberOfNodesVisited() const {
+  size_t visited = 0;
+  for (vector<BitVectorDefUseAnalysisPF*>::const_iterator i = functions.begin(); i != functions.end(); ++i)
+    visited += (*i)->getNumberOfNodesVisited();
+  return visited;
+}
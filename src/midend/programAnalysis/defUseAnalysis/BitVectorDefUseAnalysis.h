@@ -0,0 +1,159 @@
+/******************************************
+ * Category: DFA
+ * Bit vector DefUse Analysis Declaration
+ *
+ * Reaching definitions and reaching uses, computed per function on a
+ * StaticCFG::FlatCFG of the DFA-filtered CFG (see DFAFilter.h) with one
+ * Sawyer::Container::BitVector per CFG node.
+ *
+ * The definition sites (and use sites) of a function are numbered densely
+ * and grouped by variable, so that the definitions of one variable are a
+ * contiguous range of bits: a definition kills the other definitions of its
+ * variable by clearing that range, and the meet of two nodes is a word-wise
+ * OR over the whole vector. The results are returned by reference (no
+ * copying of tables as in DefUseAnalysis).
+ *****************************************/
+
+#ifndef __BitVectorDefUseAnalysis_HXX_LOADED__
+#define __BitVectorDefUseAnalysis_HXX_LOADED__
+
+#include "filteredCFG.h"
+#include "flatCFG.h"
+#include "support.h"
+#include "DFAFilter.h"
+
+#include <sawyer/BitVector.h>
+#include <boost/unordered_map.hpp>
+#include <vector>
+#include <utility>
+
+/******************************************
+ * Def-use analysis of one function
+ *****************************************/
+class ROSE_DLL_API BitVectorDefUseAnalysisPF {
+ public:
+  typedef Sawyer::Container::BitVector BitVector;
+  typedef Sawyer::Container::BitVector::BitRange BitRange;
+  typedef StaticCFG::FlatCFG::NodeId NodeId;
+  // a definition or use site: the variable and the node that defines/uses it
+  typedef std::pair<SgInitializedName*, SgNode*> SiteType;
+
+  // analyze the function; the globals are defined at the function entry
+  BitVectorDefUseAnalysisPF(SgFunctionDefinition* function,
+                            const std::vector<SgInitializedName*>& globals);
+
+  SgFunctionDefinition* getFunction() const { return function; }
+  const StaticCFG::FlatCFG& getCFG() const { return cfg; }
+
+  // the definition/use sites, by bit number
+  size_t getNumberOfDefinitions() const { return defs.size(); }
+  size_t getNumberOfUses() const { return uses.size(); }
+  const SiteType& getDefinition(size_t bit) const { return defs[bit]; }
+  const SiteType& getUse(size_t bit) const { return uses[bit]; }
+
+  // the bits of the definitions/uses of a variable (empty if none)
+  BitRange getDefinitionsOf(SgInitializedName* var) const;
+  BitRange getUsesOf(SgInitializedName* var) const;
+
+  // definitions/uses reaching the end of a CFG node
+  const BitVector& getReachingDefinitions(NodeId n) const { return defsOut[n]; }
+  const BitVector& getReachingUses(NodeId n) const { return usesOut[n]; }
+
+  // same for an AST node (the last of its CFG nodes); NULL if the node
+  // is not in the CFG of the function
+  const BitVector* getReachingDefinitions(SgNode* node) const;
+  const BitVector* getReachingUses(SgNode* node) const;
+
+  // append the nodes that define/use var and reach node to result (the
+  // queries of DefUseAnalysis::getDefFor/getUseFor); returns the number added
+  size_t getDefFor(SgNode* node, SgInitializedName* var, std::vector<SgNode*>& result) const;
+  size_t getUseFor(SgNode* node, SgInitializedName* var, std::vector<SgNode*>& result) const;
+
+  // number of CFG nodes whose transfer function was evaluated
+  size_t getNumberOfNodesVisited() const { return nrOfNodesVisited; }
+
+ private:
+  // a site found while scanning the CFG; bit is assigned by numberSites
+  struct Site {
+    size_t var;
+    SgNode* node;
+    NodeId cfgNode;
+    bool kills;
+    size_t bit;
+  };
+
+  // the gen set (bits) and kill set (variables) of every CFG node, in
+  // compressed sparse row format as the edges of the FlatCFG
+  struct Transfer {
+    std::vector<size_t> genOffsets, gen;
+    std::vector<size_t> killOffsets, kill;
+  };
+
+  size_t getVariable(SgInitializedName* var);
+  void addDefinition(std::vector<Site>& sites, SgInitializedName* var, SgNode* node,
+                     NodeId n, bool kills);
+  void collectSites(const std::vector<SgInitializedName*>& globals,
+                    std::vector<Site>& defSites, std::vector<Site>& useSites);
+  void numberSites(std::vector<Site>& sites, std::vector<SiteType>& numbered,
+                   std::vector<BitRange>& ranges);
+  void buildTransfer(const std::vector<Site>& genSites, const std::vector<Site>& killSites,
+                     Transfer& transfer) const;
+  void solve(const Transfer& transfer, const std::vector<BitRange>& ranges, size_t nbits,
+             std::vector<BitVector>& out);
+  NodeId getLastCFGNode(SgNode* node) const;
+  size_t appendSites(SgNode* node, SgInitializedName* var, const std::vector<BitVector>& out,
+                     const std::vector<SiteType>& sites, const std::vector<BitRange>& ranges,
+                     std::vector<SgNode*>& result) const;
+
+  SgFunctionDefinition* function;
+  StaticCFG::FlatCFG cfg;
+
+  // dense numbering of the variables and of the AST nodes (last CFG node)
+  boost::unordered_map<SgInitializedName*, size_t> varIds;
+  std::vector<SgInitializedName*> vars;
+  boost::unordered_map<SgNode*, NodeId> lastCFGNode;
+
+  // sites by bit number, and the bits of the sites of each variable
+  std::vector<SiteType> defs, uses;
+  std::vector<BitRange> defRanges, useRanges;
+
+  std::vector<BitVector> defsOut, usesOut;
+  size_t nrOfNodesVisited;
+};
+
+/******************************************
+ * Def-use analysis of all functions of a project
+ *****************************************/
+class ROSE_DLL_API BitVectorDefUseAnalysis : Support {
+ public:
+  BitVectorDefUseAnalysis(SgProject* project);
+  ~BitVectorDefUseAnalysis();
+
+  // analyze all functions (as DefUseAnalysis::run, the functions in the std
+  // namespace and in system headers are skipped); returns 0
+  int run();
+
+  // analyze one function, replacing the previous results for it
+  const BitVectorDefUseAnalysisPF* run(SgFunctionDefinition* function);
+
+  // the analysis of the function containing node, or NULL
+  const BitVectorDefUseAnalysisPF* getFunctionAnalysis(SgNode* node) const;
+
+  size_t getDefFor(SgNode* node, SgInitializedName* var, std::vector<SgNode*>& result) const;
+  size_t getUseFor(SgNode* node, SgInitializedName* var, std::vector<SgNode*>& result) const;
+
+  const std::vector<SgInitializedName*>& getGlobalVariables() const { return globalVarList; }
+  size_t getNumberOfNodesVisited() const;
+
+ private:
+  void find_all_global_variables();
+  void clear();
+
+  SgProject* project;
+  std::vector<SgInitializedName*> globalVarList;
+  bool globalsFound;
+  std::vector<BitVectorDefUseAnalysisPF*> functions;
+  boost::unordered_map<SgNode*, BitVectorDefUseAnalysisPF*> functionOfNode;
+};
+
+#endif
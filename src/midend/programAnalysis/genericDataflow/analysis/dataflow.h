@@ -207,13 +207,38 @@ class FindAllFunctionCalls : public UnstructuredPassIntraAnalysis
 class IntraUniDirectionalDataflow : public IntraUnitDataflow
 {
         public:
+        IntraUniDirectionalDataflow(): numIterations(0), numTransfers(0), numSkippedTransfers(0)
+        {}
 
         // Runs the intra-procedural analysis on the given function and returns true if
         // the function's NodeState gets modified as a result and false otherwise
         // state - the function's NodeState
         bool runAnalysis(const Function& func, NodeState* state, bool analyzeDueToCallers, std::set<Function> calleesUpdated);
 
+        // Returns the number of nodes taken from the worklist by runAnalysis, over all the functions
+        // analyzed since the last call to resetCounts()
+        unsigned long getNumIterations() const { return numIterations; }
+
+        // Returns the number of times the transfer function was applied by runAnalysis, over all the
+        // functions analyzed since the last call to resetCounts()
+        unsigned long getNumTransfers() const { return numTransfers; }
+
+        // Returns the number of nodes taken from the worklist by runAnalysis whose incoming lattices had not
+        // changed since their last transfer, so that neither the copy into their outgoing lattices nor the
+        // transfer function was done, over all the functions analyzed since the last call to resetCounts()
+        unsigned long getNumSkippedTransfers() const { return numSkippedTransfers; }
+
+        void resetCounts() { numIterations = numTransfers = numSkippedTransfers = 0; }
+
         protected:
+        unsigned long numIterations;
+        unsigned long numTransfers;
+        unsigned long numSkippedTransfers;
+
+        // The NodeStates of each function whose outgoing lattices are the result of the transfer function applied
+        // to their current incoming lattices. A NodeState is removed when its incoming lattices change.
+        std::map<Function, std::set<NodeState*> > upToDate;
+
         // propagates the dataflow info from the current node's NodeState (curNodeState) to the next node's
         // NodeState (nextNodeState)
         bool propagateStateToNextNode(
@@ -224,7 +249,8 @@ class IntraUniDirectionalDataflow : public IntraUnitDataflow
                                                     DataflowNode (DataflowEdge::*edgeFn)() const);
 
         virtual NodeState*initializeFunctionNodeState(const Function &func, NodeState *fState) = 0;
-        virtual VirtualCFG::dataflow*
+        // Returns the worklist of the function, holding the nodes where the analysis of the function starts
+        virtual VirtualCFG::priority_dataflow*
           getInitialWorklist(const Function &func, bool firstVisit, bool analyzeDueToCallers, const set<Function> &calleesUpdated, NodeState *fState) = 0;
         virtual vector<Lattice*> getLatticeAnte(NodeState *state) = 0;
         virtual vector<Lattice*> getLatticePost(NodeState *state) = 0;
@@ -247,7 +273,7 @@ class IntraFWDataflow  : public IntraUniDirectionalDataflow
         {}
 
         NodeState* initializeFunctionNodeState(const Function &func, NodeState *fState);
-        VirtualCFG::dataflow*
+        VirtualCFG::priority_dataflow*
           getInitialWorklist(const Function &func, bool firstVisit, bool analyzeDueToCallers, const set<Function> &calleesUpdated, NodeState *fState);
         vector<Lattice*> getLatticeAnte(NodeState *state);
         vector<Lattice*> getLatticePost(NodeState *state);
@@ -265,7 +291,7 @@ class IntraBWDataflow  : public IntraUniDirectionalDataflow
         {}
 
         NodeState* initializeFunctionNodeState(const Function &func, NodeState *fState);
-        VirtualCFG::dataflow*
+        VirtualCFG::priority_dataflow*
           getInitialWorklist(const Function &func, bool firstVisit, bool analyzeDueToCallers, const set<Function> &calleesUpdated, NodeState *fState);
         virtual vector<Lattice*> getLatticeAnte(NodeState *state);
         virtual vector<Lattice*> getLatticePost(NodeState *state);
@@ -478,7 +504,49 @@ class ContextInsensitiveInterProceduralDataflow : virtual public InterProcedural
         std::map<Function, std::set<Function> > remainingDueToCalls;
 
         public:
-        ContextInsensitiveInterProceduralDataflow(IntraProceduralDataflow* intraDataflowAnalysis, SgIncidenceDirectedGraph* graph) ;
+        // The order in which the strongly connected components (SCCs) of the call graph are processed:
+        // callers before their callees (topDown) or callees before their callers (bottomUp)
+        enum SCCOrder { topDown, bottomUp };
+
+        protected:
+        SCCOrder order;
+
+        // The number of threads used to analyze leaf functions (1: one at a time, 0: the default number)
+        size_t nThreads;
+
+        // The functions, grouped by SCC and listed SCC by SCC in processing order. The functions of an SCC
+        // have consecutive positions in schedule: sccBegin[i] is the position of the first function of the
+        // SCC of the function at position i.
+        std::vector<const CGFunction*> schedule;
+        std::vector<size_t> sccBegin;
+        std::map<const CGFunction*, size_t> schedulePos;
+
+        // Maps the canonical declaration of each function to its CGFunction
+        std::map<SgFunctionDeclaration*, const CGFunction*> funcOfDecl;
+
+        // The callers of each function (only those that have definitions)
+        std::map<const CGFunction*, std::set<const CGFunction*> > callersOf;
+
+        // The functions that call no function that has a definition (not even themselves). Their analysis
+        // reads and writes no other function's state, so that leaves may be analyzed concurrently.
+        std::set<const CGFunction*> leaves;
+
+        // The positions in schedule of the functions that still remain to be processed
+        std::set<size_t> pending;
+
+        // The number of times the intra-procedural analysis was run by runAnalysis(), and how many of those runs
+        // were done concurrently with others
+        unsigned long numVisits;
+        unsigned long numConcurrentVisits;
+
+        public:
+        // order - the order in which the SCCs of the call graph are processed
+        // nThreads - if not 1, batches of leaf functions are analyzed concurrently by this many threads (0 for
+        //            the default number). The intra-procedural analysis (including its lattices) must then be
+        //            safe to run on different functions at the same time. Leaves are always analyzed one at a
+        //            time while analysisDebugLevel>=1.
+        ContextInsensitiveInterProceduralDataflow(IntraProceduralDataflow* intraDataflowAnalysis, SgIncidenceDirectedGraph* graph,
+                                                  SCCOrder order=topDown, size_t nThreads=1);
 
         public:
 
@@ -496,11 +564,48 @@ class ContextInsensitiveInterProceduralDataflow : virtual public InterProcedural
         bool transfer(const Function& func, const DataflowNode& n, NodeState& state,
                       const std::vector<Lattice*>& dfInfo, std::vector<Lattice*>** retState, bool fw);
 
-        // Uses TraverseCallGraphDataflow to traverse the call graph.
+        // Analyzes the functions until their dataflow states stop changing. The SCCs of the call graph are
+        // processed in the given order, each until none of its functions remains to be processed, and a
+        // function is only processed again if its incoming state or the state at the exit of one of its
+        // callees changed.
         void runAnalysis();
 
-        // Runs the intra-procedural analysis every time TraverseCallGraphDataflow passes a function.
+        // Runs the intra-procedural analysis on the given function and re-schedules its callers if the
+        // dataflow state at its exit changed.
         void visit(const CGFunction* func);
+
+        // Returns the number of times runAnalysis() ran the intra-procedural analysis on a function
+        unsigned long getNumVisits() const { return numVisits; }
+
+        // Returns the number of those runs that were done concurrently, in batches of leaves
+        unsigned long getNumConcurrentVisits() const { return numConcurrentVisits; }
+
+        // Returns the number of functions that are leaves of the call graph (see leaves), once runAnalysis() has
+        // built the schedule
+        size_t getNumLeaves() const { return leaves.size(); }
+
+        protected:
+        // Computes the SCCs of the call graph and fills schedule, sccBegin, schedulePos, callersOf and leaves
+        void buildSchedule();
+
+        // Moves the functions added to the remaining list (by transfer() and visit()) to pending
+        void schedulePending();
+
+        // Prepares the given function for its analysis and returns the arguments of its runAnalysis()
+        void startVisit(const Function& func, bool& analyzeDueToCallers, std::set<Function>& calleesUpdated);
+
+        // Runs the intra-procedural analysis on the function and merges the states at its return statements.
+        // Returns true if the merged states changed.
+        bool analyze(const Function& func, bool analyzeDueToCallers, std::set<Function> calleesUpdated);
+
+        // Calls analyze() and records its result in *modified (used for concurrent analyses)
+        void analyzeInto(const Function& func, bool analyzeDueToCallers, std::set<Function> calleesUpdated, bool* modified);
+
+        // Records that the callers of the given function must be processed again because of their calls to it
+        void addCallers(const CGFunction* funcCG);
+
+        // Analyzes the pending leaves that are ready to be processed (see leaves) concurrently
+        void visitLeaves();
 };
 
 #endif
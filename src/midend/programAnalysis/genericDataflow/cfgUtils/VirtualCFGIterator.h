@@ -6,8 +6,10 @@
 //#include "baseCFGIterator.h"
 
 #include <list>
+#include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace VirtualCFG{
 
@@ -156,5 +158,53 @@ class back_dataflow: /*public virtual BaseCFG::back_dataflow,*/ public virtual d
                 
         void operator ++ (int);
 };
+
+// Dataflow worklist that hands out its nodes in reverse postorder of the CFG (of the reverse CFG if fwDir=false),
+// numbered by a depth-first search from a root node. As with the dataflow iterator, every node downstream from the
+// nodes added with add() is visited at least once and a visited node is only visited again if it is added again
+// (i.e. if its incoming dataflow state changed). Among the pending nodes, the one that comes first in reverse
+// postorder is visited first, so that a node is normally visited after all its predecessors have been updated
+// (except along back edges) and each node is queued at most once.
+class priority_dataflow
+{
+        DataflowNode terminator;
+        bool fwDir;
+
+        // the numbered nodes, in reverse postorder, and the numbers of their descendants
+        std::vector<DataflowNode> nodes;
+        std::map<DataflowNode, size_t> ids;
+        std::vector<std::vector<size_t> > descendants;
+
+        // visited[i]/queued[i] are true if nodes[i] has been visited / is pending
+        std::vector<bool> visited;
+        std::vector<bool> queued;
+        std::set<size_t> pending;
+
+        public:
+        // root - the node the reverse postorder is computed from (the function's start for forward analyses and
+        //        its end for backward analyses); it is not added to the worklist
+        // terminator_arg - the node that is never visited
+        priority_dataflow(const DataflowNode &root, const DataflowNode &terminator_arg, bool fwDir);
+
+        // Adds the given node to the worklist, unless it is the terminator or already pending
+        void add(const DataflowNode &next);
+
+        // Returns true if there are no more nodes to visit
+        bool empty() const { return pending.empty(); }
+
+        // Removes the pending node that comes first in reverse postorder from the worklist and returns it. When a
+        // node is returned for the first time, its descendants that have not been visited yet are added.
+        DataflowNode pop();
+
+        // Returns the number of nodes numbered so far
+        size_t size() const { return nodes.size(); }
+
+        std::string str(std::string indent="");
+
+        protected:
+        // Numbers the nodes that are reachable from start and have no number yet, in reverse postorder, after
+        // the nodes numbered by previous calls. Returns the number of start.
+        size_t number(const DataflowNode &start);
+};
 }
 #endif
@@ -143,8 +143,14 @@ public:
     /** Run the analysis. If interprocedural analysis is not enabled, functionc all expressions (SgFunctionCallExp) will not
      * count as definitions of any variables.
      * @param interprocedural true to enable interprocedural analysis, false to perform no interprocedural analysis. 
-     * @param treatPointersAsStructures if true, p->x is versioned as if it were the variable p.x. */
-    void run(bool interprocedural, bool treatPointersAsStructures);
+     * @param treatPointersAsStructures if true, p->x is versioned as if it were the variable p.x.
+     * @param nThreads number of threads used to analyze functions concurrently (zero means one per hardware thread).
+     *        The local defs and uses, and later the phi functions and reaching defs, of each function are computed in
+     *        tables private to the function and then moved into the tables of this object; the interprocedural
+     *        propagation runs on one thread in between. Functions nested in other functions (e.g. member functions of
+     *        local classes) share AST nodes with them and are processed on one thread. The results are the same
+     *        as with one thread. */
+    void run(bool interprocedural, bool treatPointersAsStructures, size_t nThreads = 1);
 
     static bool getDebug()
     {
@@ -157,6 +163,26 @@ public:
     }
 
 private:
+    /** Find the local defs and uses of the function and expand them (the part of run() before interprocedural analysis). */
+    void insertLocalDefsAndUses(SgFunctionDefinition* func, bool treatPointersAsStructures);
+
+    /** Insert phi functions, number the definitions and propagate them in the function (the part of run() after
+     * interprocedural analysis). */
+    void calculateReachingDefs(SgFunctionDefinition* func);
+
+    /** Copy the local def and use tables of the function into the empty tables of another StaticSingleAssignment, then
+     * calculate the reaching defs of the function there. Only reads the tables of this object. */
+    void calculateReachingDefsInto(SgFunctionDefinition* func, StaticSingleAssignment* functionSsa) const;
+
+    /** Move all the entries of the tables of another StaticSingleAssignment into this one, replacing the entries
+     * of the same nodes. */
+    void moveTablesFrom(StaticSingleAssignment& other);
+
+    /** Split the functions into those that can be analyzed concurrently and those nested in (or containing) another
+     * function of the list. The order of the functions is kept. */
+    static void partitionNestedFunctions(const std::vector<SgFunctionDefinition*>& functions,
+            std::vector<SgFunctionDefinition*>& independentFunctions, std::vector<SgFunctionDefinition*>& nestedFunctions);
+
     /** Once all the local definitions have been inserted in the ssaLocalDefsTable and phi functions have been inserted
      * in the reaching defs table, propagate reaching definitions along the CFG. */
     void runDefUseDataFlow(SgFunctionDefinition* func);
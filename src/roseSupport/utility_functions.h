@@ -44,6 +44,14 @@ ROSE_DLL_API SgProject* frontend ( const std::vector<std::string>& argv, bool fr
 SgProject* frontendShell ( int argc, char** argv);
 ROSE_DLL_API SgProject* frontendShell ( const std::vector<std::string>& argv);
 
+// Builds the same SgProject as frontend(), running the frontend and AST postprocessing of the source files in up to
+// nWorkers forked processes (zero means one per processor). Each worker handles a contiguous part of the file list and
+// writes its AST with AST_FILE_IO; the ASTs are then read into this process and combined into one SgProject with the
+// files in command line order. Declarations from header files are not shared between files handled by different workers
+// (mergeAST() can be used for that). Runs frontend() instead for a single file, for Java and binary files, where fork()
+// is not available, and if IR nodes have already been built by this process.
+ROSE_DLL_API SgProject* frontendParallel ( const std::vector<std::string>& argv, size_t nWorkers = 0, bool frontendConstantFolding = false );
+
 // DQ (3/18/2006): Modified backend function interface to permit handling of user specified
 // objects to control the formatting of code generation and the use of alternative code generation
 // techniques (e.g. copy-based code generation).
@@ -0,0 +1,79 @@
+// Fast block compression for large binary files. See BlockCompression::compressBlock.
+#ifndef ROSE_BlockCompression_H
+#define ROSE_BlockCompression_H
+
+#include "rosedll.h"
+
+#include <boost/cstdint.hpp>
+#include <stdint.h>
+#include <string>
+
+namespace rose {
+
+/** Compression of blocks of binary data.
+ *
+ *  These functions favor speed over compression ratio and have no dependencies, so they can be used for data that's written
+ *  and read often, such as the binary AST files.  A block is compressed with an LZ77 algorithm similar to LZ4: a byte
+ *  sequence is coded as a run of literal bytes followed by a copy of earlier output, which is found with a hash table of
+ *  four-byte prefixes and a 64 kB window.
+ *
+ *  Arrays of fixed-size records, such as arrays of structs whose members are mostly integers, compress much better if they're
+ *  first transformed with @ref encodeRecords.  For example:
+ *
+ * @code
+ *  std::string encoded, compressed;
+ *  BlockCompression::encodeRecords((const uint8_t*)array, sizeof(array[0]), nElements, encoded);
+ *  BlockCompression::compressBlock((const uint8_t*)encoded.data(), encoded.size(), compressed);
+ * @endcode
+ *
+ *  The formats are those of the machine that writes them; they're not portable between machines of different byte
+ *  orders.
+ *
+ *  Thread safety: All functions are thread safe. */
+namespace BlockCompression {
+
+/** Size of the header that precedes each compressed block.
+ *
+ *  The header is the 32-bit uncompressed size followed by the 32-bit size of the payload that follows the header. If both
+ *  are equal then the payload is stored uncompressed because compression didn't make it smaller. */
+static const size_t blockHeaderSize = 8;
+
+/** Largest block that can be compressed. */
+static const size_t maxBlockSize = 0x7fffffff;
+
+/** Compress one block.
+ *
+ *  Appends the header and payload of @p size bytes starting at @p data to the @p out string. */
+ROSE_UTIL_API void compressBlock(const uint8_t *data, size_t size, std::string &out /*in,out*/);
+
+/** Parse a block header.
+ *
+ *  Returns the uncompressed size and payload size of the block whose header is at @p header, which must point to @ref
+ *  blockHeaderSize bytes. */
+ROSE_UTIL_API void parseBlockHeader(const uint8_t *header, size_t &size /*out*/, size_t &payloadSize /*out*/);
+
+/** Decompress one block.
+ *
+ *  Decompresses the @p payloadSize bytes of payload at @p payload, which must follow a header that says the uncompressed size
+ *  is @p size, into the @p size bytes at @p out.  Returns false if the payload is corrupt, in which case the contents of @p
+ *  out are unspecified. */
+ROSE_UTIL_API bool decompressBlock(const uint8_t *payload, size_t payloadSize, uint8_t *out, size_t size);
+
+/** Encode an array of fixed-size records.
+ *
+ *  Each record is treated as a sequence of 64-bit words followed by up to seven bytes. The words are stored column by column,
+ *  each as the difference from the same word of the previous record in zig-zag variable-length form, so that columns of
+ *  small integers, null pointers, and increasing indices become short runs of mostly identical bytes. The trailing bytes
+ *  are stored column by column unchanged.  The encoded bytes are appended to @p out. */
+ROSE_UTIL_API void encodeRecords(const uint8_t *records, size_t recordSize, size_t nRecords, std::string &out /*in,out*/);
+
+/** Decode an array of fixed-size records.
+ *
+ *  Decodes @p nRecords records of @p recordSize bytes each from the @p size bytes at @p data, which were produced by @ref
+ *  encodeRecords, and stores them at @p records.  Returns false if the data is corrupt. */
+ROSE_UTIL_API bool decodeRecords(const uint8_t *data, size_t size, size_t recordSize, size_t nRecords, uint8_t *records);
+
+} // namespace
+} // namespace
+
+#endif
@@ -0,0 +1,90 @@
+// Process-wide pool of unique strings. See InternedString.
+#ifndef ROSE_InternedString_H
+#define ROSE_InternedString_H
+
+#include "rosedll.h"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace rose {
+
+/** Handle to a string in the process-wide string pool.
+ *
+ *  Constructing an interned string from a std::string or C string looks it up in the pool and adds it if it isn't present,
+ *  so that there is only ever one copy of each distinct string no matter how many handles refer to it.  A handle is the size
+ *  of a pointer, copying it doesn't copy the string, and comparing or hashing handles compares or hashes the pointers.  This
+ *  is meant for long strings that are repeated many times, such as the mangled names of declarations that appear in many
+ *  translation units, and for containers keyed by such strings:
+ *
+ * @code
+ *  boost::unordered_map<InternedString, SgNode*> nodesByName;   // uses hash_value(InternedString)
+ *  nodesByName[declaration->get_mangled_name().getString()] = declaration;
+ * @endcode
+ *
+ *  Strings are never removed from the pool, so the reference returned by @ref str is valid until the program exits.
+ *
+ *  Thread safety: All functions may be called concurrently. The pool is divided into independently locked stripes. */
+class ROSE_UTIL_API InternedString {
+    const std::string *string_;                         // the pool's copy; never null
+
+public:
+    /** Constructs the empty string. */
+    InternedString();
+
+    /** Interns a string.
+     *
+     *  These constructors are implicit so that strings can be used wherever interned strings are expected.
+     * @{ */
+    InternedString(const std::string&);
+    InternedString(const char*);
+    /** @} */
+
+    /** The string. */
+    const std::string& str() const { return *string_; }
+
+    /** Implicit conversion to the string. */
+    operator const std::string&() const { return *string_; }
+
+    /** Properties of the string.
+     * @{ */
+    const char* c_str() const { return string_->c_str(); }
+    size_t size() const { return string_->size(); }
+    bool empty() const { return string_->empty(); }
+    /** @} */
+
+    /** Compare two interned strings.
+     *
+     *  Equality is pointer equality. Ordering is lexicographic so that sorted containers are deterministic.
+     * @{ */
+    bool operator==(const InternedString &other) const { return string_ == other.string_; }
+    bool operator!=(const InternedString &other) const { return string_ != other.string_; }
+    bool operator<(const InternedString &other) const { return string_ != other.string_ && *string_ < *other.string_; }
+    /** @} */
+
+    /** Hash based on the string's identity. */
+    size_t hash() const { return (size_t)string_ >> 4 ^ (size_t)string_; }
+
+    /** Number of distinct strings in the pool. */
+    static size_t nStrings();
+
+    /** Total length of the distinct strings in the pool, in bytes. */
+    static size_t nBytes();
+};
+
+/** Hash function found by boost::hash. */
+inline size_t hash_value(const InternedString &s) {
+    return s.hash();
+}
+
+/** Hasher for containers that take one as a template argument. */
+struct InternedStringHash {
+    size_t operator()(const InternedString &s) const { return s.hash(); }
+};
+
+ROSE_UTIL_API std::ostream& operator<<(std::ostream&, const InternedString&);
+
+} // namespace
+
+#endif
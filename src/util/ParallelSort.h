@@ -1,9 +1,14 @@
-// Parallel sorting using multiple threads. See ParallelSort::quicksort() near the end of this file.
+// Parallel sorting using multiple threads. See ParallelSort::quicksort(), mergesort(), and samplesort() near the end of this
+// file.
 #ifndef ROSE_ParallelSort_H
 #define ROSE_ParallelSort_H
 
-#include <boost/thread.hpp>
-#include <list>
+#include "WorkStealing.h"
+
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <iterator>
 #include <vector>
 
 namespace rose {
@@ -15,32 +20,22 @@ namespace rose {
  *  algorithms are implemented:
  *
  *  <ul>
- *   <li>quicksort()</li>
+ *   <li>quicksort() sorts in place and is not stable.</li>
+ *   <li>mergesort() is stable, like std::stable_sort, but needs a temporary copy of the values.</li>
+ *   <li>samplesort() is not stable and needs a temporary copy of the values, but divides the work evenly among threads
+ *       regardless of the initial order of the values.</li>
  *  </ul>
- */
+ *
+ *  All of them schedule their work on a @ref WorkStealing::Pool, so each thread works mostly from its own queue and idle
+ *  threads steal from busy ones rather than contending for a single shared work list.  Ranges smaller than a threshold are
+ *  sorted by a single thread with the corresponding standard library algorithm. */
 namespace ParallelSort {
 
 // This stuff is all private but useful for any parallel sort algorithm.
 namespace Private {
 
-// A unit of work.  The values to be worked on are specified by a begin (inclusive) and end (exclusive) iterator.
-template<class RandomAccessIterator>
-struct Work {
-    RandomAccessIterator begin, end;
-    Work(RandomAccessIterator begin, RandomAccessIterator end): begin(begin), end(end) {}
-};
-
-// Information about a sorting job.  A job is generated when the user requests a sort, and each job may have multiple threads.
-template<class RandomAccessIterator, class Compare>
-struct Job {
-    Compare compare;                                    // functor to compare two values, like for std::sort()
-    boost::condition_variable worklistInsertion;        // signaled when something is added to the worklist
-    static const int multiThreshold = 10000;            // size at which to start multi-threading
-    boost::mutex mutex;                                 // protects all of the following data members
-    std::list<Work<RandomAccessIterator> > worklist;    // non-overlapping stuff that needs to be sorted
-    size_t npending;                                    // number of workers that are processing jobs that aren't in worklist
-    Job(Compare compare): compare(compare), npending(0) {}
-};
+// Ranges smaller than this are sorted by one thread.
+static const size_t multiThreshold = 10000;
 
 // Somewhat like std::partition(). Partitions the iterator range into two parts according to the value at the pivot iterator
 // and returns an iterator for the beginning of the second part.  The values of the first part will all be less than the pivot
@@ -60,60 +55,156 @@ RandomAccessIterator partition(RandomAccessIterator begin, RandomAccessIterator
     return pivot;
 }
 
-// Add work to the work list
+// Returns whichever of the three iterators points to the median value.  Using this as the pivot avoids quadratic behavior
+// for values that are already sorted or reverse sorted.
 template<class RandomAccessIterator, class Compare>
-void addWork(Job<RandomAccessIterator, Compare> &job, const Work<RandomAccessIterator> &work) {
-    boost::lock_guard<boost::mutex> lock(job.mutex);
-    job.worklist.push_back(work);
-    job.worklistInsertion.notify_one();
+RandomAccessIterator medianOfThree(RandomAccessIterator a, RandomAccessIterator b, RandomAccessIterator c, Compare compare) {
+    if (compare(*a, *b)) {
+        if (compare(*b, *c))
+            return b;
+        return compare(*a, *c) ? c : a;
+    } else {
+        if (compare(*a, *c))
+            return a;
+        return compare(*b, *c) ? c : b;
+    }
 }
 
-// Sorts one unit of work, adding additional items to the worklist if necessary.
+// True for values that are not greater than a given value.
+template<class T, class Compare>
+struct NotGreater {
+    const T &value;
+    Compare compare;
+    NotGreater(const T &value, Compare compare): value(value), compare(compare) {}
+    bool operator()(const T &x) { return !compare(value, x); }
+};
+
+// Integer base-two logarithm, rounded down.
+inline size_t
+log2(size_t n) {
+    size_t retval = 0;
+    while (n > 1) {
+        n >>= 1;
+        ++retval;
+    }
+    return retval;
+}
+
+// Number of threads actually used for a sort of n values.
+inline size_t
+nThreadsFor(size_t n, size_t nthreads) {
+    return n < multiThreshold ? 1 : std::max(nthreads, (size_t)1);
+}
+
+// Sorts one range, adding its right part to the pool as a new task whenever it's partitioned.  If partitioning goes badly
+// (depthLimit reaches zero) the rest of the range is sorted with std::sort instead, which is an introsort and thus never
+// quadratic.
 template<class RandomAccessIterator, class Compare>
-void quicksort(Job<RandomAccessIterator, Compare> &job, Work<RandomAccessIterator> work) {
-    while (work.end - work.begin > 1) {
-        if (work.end - work.begin < job.multiThreshold) {
-            std::sort(work.begin, work.end, job.compare);
+void quicksortTask(WorkStealing::Pool &pool, RandomAccessIterator begin, RandomAccessIterator end, Compare compare,
+                   size_t depthLimit) {
+    while (end - begin > 1) {
+        if (end - begin < (ptrdiff_t)multiThreshold || 0 == depthLimit) {
+            std::sort(begin, end, compare);
             return;
-        } else {
-            RandomAccessIterator pivot = work.begin + (work.end - work.begin) / 2; // assuming fairly even distribution
-            pivot = partition(work.begin, work.end, pivot, job.compare);
-            addWork(job, Work<RandomAccessIterator>(pivot+1, work.end));
-            work.end = pivot;
         }
+        --depthLimit;
+        RandomAccessIterator pivot = medianOfThree(begin, begin + (end - begin) / 2, end - 1, compare);
+        pivot = partition(begin, end, pivot, compare);
+        if (pivot == begin) {
+            // Nothing is less than the pivot, which happens when the range has many values equal to it.  All the values equal
+            // to the pivot are already in their final positions, so leave them out and continue with the greater values.
+            typedef typename std::iterator_traits<RandomAccessIterator>::value_type Value;
+            begin = std::partition(begin+1, end, NotGreater<Value, Compare>(*begin, compare));
+            continue;
+        }
+        pool.submit(boost::bind(quicksortTask<RandomAccessIterator, Compare>, boost::ref(pool), pivot+1, end, compare,
+                                depthLimit));
+        end = pivot;
     }
 }
 
-// A worker thread.
 template<class RandomAccessIterator, class Compare>
-struct Worker {
-    Job<RandomAccessIterator, Compare> &job;
-    size_t id;                                          // only for debugging
-    Worker(Job<RandomAccessIterator, Compare> &job, size_t id): job(job), id(id) {}
-    void operator()() {
-        boost::unique_lock<boost::mutex> lock(job.mutex);
-        while (true) {
-            // Get the next unit of work. If no workers are working and the worklist is empty then we're all done.
-            while (job.worklist.empty() && job.npending>0)
-                job.worklistInsertion.wait(lock);
-            if (job.worklist.empty())
-                return;
-            Work<RandomAccessIterator> work = job.worklist.front();
-            job.worklist.pop_front();
-            ++job.npending;
-
-            // Sort that unit of work
-            lock.unlock();
-            quicksort(job, work);
-            lock.lock();
-
-            // Indicate that the work is completed
-            assert(job.npending>0);
-            if (0==--job.npending && job.worklist.empty())
-                job.worklistInsertion.notify_all();
+void stableSortTask(RandomAccessIterator begin, RandomAccessIterator end, Compare compare) {
+    std::stable_sort(begin, end, compare);
+}
+
+template<class InputIterator, class OutputIterator>
+void copyTask(InputIterator begin, InputIterator end, OutputIterator out) {
+    std::copy(begin, end, out);
+}
+
+// Number of values to take from the first sorted range when merging the first k values of two sorted ranges.  Ties are
+// resolved in favor of the first range, like std::merge, so that merging is stable.
+template<class RandomAccessIterator, class Compare>
+size_t mergeSplit(RandomAccessIterator a, size_t na, RandomAccessIterator b, size_t nb, size_t k, Compare compare) {
+    size_t lo = k > nb ? k - nb : 0;
+    size_t hi = std::min(k, na);
+    while (lo < hi) {
+        size_t i = (lo + hi) / 2;
+        size_t j = k - i;
+        if (j > 0 && !compare(*(b + (j-1)), *(a + i))) {
+            lo = i + 1;                                 // a[i] comes before b[j-1], so more must be taken from a
+        } else {
+            hi = i;
         }
     }
-};
+    return lo;
+}
+
+// Merges output positions [kBegin,kEnd) of the merge of two adjacent sorted ranges.
+template<class InputIterator, class OutputIterator, class Compare>
+void mergeTask(InputIterator a, size_t na, InputIterator b, size_t nb, OutputIterator out, size_t kBegin, size_t kEnd,
+               Compare compare) {
+    size_t i0 = mergeSplit(a, na, b, nb, kBegin, compare), j0 = kBegin - i0;
+    size_t i1 = mergeSplit(a, na, b, nb, kEnd, compare), j1 = kEnd - i1;
+    std::merge(a + i0, a + i1, b + j0, b + j1, out + kBegin, compare);
+}
+
+// One pass of a bottom-up merge sort: merges adjacent pairs of sorted runs from src into dst and updates the run boundaries.
+// When there are fewer pairs than threads, each merge is divided into pieces that are merged in parallel.
+template<class InputIterator, class OutputIterator, class Compare>
+void mergePass(WorkStealing::Pool &pool, InputIterator src, OutputIterator dst, std::vector<size_t> &bounds /*in,out*/,
+               Compare compare) {
+    size_t nRuns = bounds.size() - 1;
+    size_t nPairs = (nRuns + 1) / 2;
+    size_t piecesPerPair = std::max((size_t)1, 2 * pool.nThreads() / nPairs);
+    std::vector<size_t> newBounds(1, 0);
+    for (size_t run=0; run<nRuns; run+=2) {
+        size_t lo = bounds[run], mid = bounds[run+1], hi = run+2 <= nRuns ? bounds[run+2] : mid;
+        size_t n = hi - lo;
+        size_t nPieces = std::max((size_t)1, std::min(piecesPerPair, n / multiThreshold));
+        for (size_t piece=0; piece<nPieces; ++piece) {
+            pool.submit(boost::bind(mergeTask<InputIterator, OutputIterator, Compare>,
+                                    src + lo, mid - lo, src + mid, hi - mid, dst + lo,
+                                    n * piece / nPieces, n * (piece+1) / nPieces, compare));
+        }
+        newBounds.push_back(hi);
+    }
+    pool.wait();
+    bounds.swap(newBounds);
+}
+
+// Classifies values by bucket. Bucket i holds values that are not less than splitter i-1 and less than splitter i.
+template<class T, class Compare>
+size_t bucketOf(const T &value, const std::vector<T> &splitters, Compare compare) {
+    return std::upper_bound(splitters.begin(), splitters.end(), value, compare) - splitters.begin();
+}
+
+template<class RandomAccessIterator, class Compare>
+void countTask(RandomAccessIterator begin, RandomAccessIterator end,
+               const std::vector<typename std::iterator_traits<RandomAccessIterator>::value_type> &splitters,
+               Compare compare, size_t *counts /*out*/) {
+    for (RandomAccessIterator i=begin; i<end; ++i)
+        ++counts[bucketOf(*i, splitters, compare)];
+}
+
+template<class RandomAccessIterator, class OutputIterator, class Compare>
+void scatterTask(RandomAccessIterator begin, RandomAccessIterator end,
+                 const std::vector<typename std::iterator_traits<RandomAccessIterator>::value_type> &splitters,
+                 Compare compare, size_t *offsets /*in,out*/, OutputIterator out) {
+    for (RandomAccessIterator i=begin; i<end; ++i)
+        *(out + offsets[bucketOf(*i, splitters, compare)]++) = *i;
+}
 
 } // namespace
 
@@ -122,6 +213,10 @@ struct Worker {
  *  @p compare using @p nthreads threads.  Multi-threading is only used if the size of the range of values exceeds a certain
  *  threshold.
  *
+ *  The pivot is the median of the first, middle, and last values, so sorted and reverse sorted input are handled well.  A
+ *  range that is partitioned too many times (more than twice the logarithm of its size) is assumed to be a bad case for
+ *  quicksort and is finished with std::sort instead.
+ *
  *  Note: using normal C++ iterators with debugging support will result in slower execution the more threads are used because
  *  the iterator dereference operators serialize some sanity checks which causes lock contention.  It is best to do the sanity
  *  check once up front, then then call the sort function with pointers.  For example:
@@ -140,24 +235,159 @@ template<class RandomAccessIterator, class Compare>
 void quicksort(RandomAccessIterator begin, RandomAccessIterator end, Compare compare, size_t nthreads) {
     assert(begin < end);
     using namespace Private;
+    size_t n = end - begin;
+    size_t depthLimit = 2 * Private::log2(n);
+    nthreads = nThreadsFor(n, nthreads);
+    if (1 == nthreads) {
+        std::sort(begin, end, compare);
+        return;
+    }
+
+    WorkStealing::Pool pool(nthreads);
+    pool.submit(boost::bind(quicksortTask<RandomAccessIterator, Compare>, boost::ref(pool), begin, end, compare, depthLimit));
+    pool.wait();
+}
 
-    Job<RandomAccessIterator, Compare> job(compare);
-    addWork(job, Work<RandomAccessIterator>(begin, end));
+/** Stable sort in parallel.  Sorts the values between @p begin (inclusive) and @p end (exclusive) according to the comparator
+ *  @p compare using @p nthreads threads.  Values that compare equal keep their original relative order, as with
+ *  std::stable_sort.
+ *
+ *  The range is divided into a few runs per thread which are sorted concurrently with std::stable_sort, and then adjacent
+ *  runs are merged pairwise until one run remains.  When there are fewer merges than threads, each merge is itself divided
+ *  into independent pieces so that all threads stay busy through the final merge.  This needs temporary storage for a copy of
+ *  the values, and the value type must be copy constructible and assignable.  See @ref quicksort for advice about iterators. */
+template<class RandomAccessIterator, class Compare>
+void mergesort(RandomAccessIterator begin, RandomAccessIterator end, Compare compare, size_t nthreads) {
+    assert(begin < end);
+    using namespace Private;
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type Value;
+    size_t n = end - begin;
+    nthreads = nThreadsFor(n, nthreads);
+    if (1 == nthreads) {
+        std::stable_sort(begin, end, compare);
+        return;
+    }
 
-    // Start worker threads (we can't assume containers with move semantics, so use an array)
-    size_t nworkers = std::max(nthreads, (size_t)1) - 1;
-    boost::thread *workers = new boost::thread[nworkers];
-    for (size_t i=0; i<nworkers; ++i)
-        workers[i] = boost::thread(Worker<RandomAccessIterator, Compare>(job, i+1));
-    
-    // Participate in the work ourselves (we might be the only thread!)
-    Worker<RandomAccessIterator, Compare>(job, 0)();
+    // Sort initial runs, a few per thread so that uneven progress is balanced by stealing.
+    WorkStealing::Pool pool(nthreads);
+    size_t nRuns = std::max((size_t)1, std::min(4 * nthreads, n / multiThreshold));
+    std::vector<size_t> bounds;
+    for (size_t i=0; i<=nRuns; ++i)
+        bounds.push_back(n * i / nRuns);
+    for (size_t i=0; i<nRuns; ++i)
+        pool.submit(boost::bind(stableSortTask<RandomAccessIterator, Compare>, begin + bounds[i], begin + bounds[i+1], compare));
+    pool.wait();
 
-    // Wait for all the threads to finish
-    for (size_t i=0; i<nworkers; ++i)
-        workers[i].join();
+    // Merge runs back and forth between the input and a temporary buffer.
+    std::vector<Value> buffer(begin, end);
+    Value *tmp = &buffer[0];
+    bool inBuffer = false;
+    while (bounds.size() > 2) {
+        if (inBuffer) {
+            mergePass(pool, tmp, begin, bounds, compare);
+        } else {
+            mergePass(pool, begin, tmp, bounds, compare);
+        }
+        inBuffer = !inBuffer;
+    }
+
+    if (inBuffer) {
+        for (size_t i=0; i<nthreads; ++i) {
+            size_t lo = n * i / nthreads, hi = n * (i+1) / nthreads;
+            pool.submit(boost::bind(copyTask<Value*, RandomAccessIterator>, tmp + lo, tmp + hi, begin + lo));
+        }
+        pool.wait();
+    }
 }
-    
+
+/** Sort values in parallel by sampling.  Sorts the values between @p begin (inclusive) and @p end (exclusive) according to
+ *  the comparator @p compare using @p nthreads threads.
+ *
+ *  A sample of the values is sorted to choose splitters that divide the values into buckets of roughly equal size, several
+ *  per thread.  The values are then counted and moved into their buckets in parallel, and the buckets are sorted
+ *  concurrently.  A bucket that turns out to be much larger than expected (e.g., because many values are equal) is sorted
+ *  with @ref quicksort's parallel algorithm on the same threads.  Unlike @ref quicksort, the amount of work given to each
+ *  thread does not depend on choosing good pivots along the way.  This needs temporary storage for a copy of the values, and
+ *  the value type must be copy constructible and assignable.  The sort is not stable.  See @ref quicksort for advice about
+ *  iterators. */
+template<class RandomAccessIterator, class Compare>
+void samplesort(RandomAccessIterator begin, RandomAccessIterator end, Compare compare, size_t nthreads) {
+    assert(begin < end);
+    using namespace Private;
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type Value;
+    size_t n = end - begin;
+    nthreads = nThreadsFor(n, nthreads);
+    if (1 == nthreads) {
+        std::sort(begin, end, compare);
+        return;
+    }
+
+    // Choose splitters from an evenly spaced sample.
+    static const size_t oversampling = 32;
+    size_t nBuckets = std::min(8 * nthreads, n / multiThreshold + 1);
+    size_t nSamples = std::min(n, nBuckets * oversampling);
+    std::vector<Value> splitters;
+    {
+        std::vector<Value> samples;
+        samples.reserve(nSamples);
+        for (size_t i=0; i<nSamples; ++i)
+            samples.push_back(*(begin + (n * i / nSamples + n / nSamples / 2)));
+        std::sort(samples.begin(), samples.end(), compare);
+        for (size_t i=1; i<nBuckets; ++i)
+            splitters.push_back(samples[nSamples * i / nBuckets]);
+    }
+    nBuckets = splitters.size() + 1;
+
+    // Count how many values of each block belong in each bucket.
+    WorkStealing::Pool pool(nthreads);
+    size_t nBlocks = 2 * nthreads;
+    std::vector<size_t> counts(nBlocks * nBuckets, 0);
+    for (size_t block=0; block<nBlocks; ++block) {
+        pool.submit(boost::bind(countTask<RandomAccessIterator, Compare>,
+                                begin + n * block / nBlocks, begin + n * (block+1) / nBlocks,
+                                boost::cref(splitters), compare, &counts[block * nBuckets]));
+    }
+    pool.wait();
+
+    // Each block's starting offset within each bucket, and the bucket boundaries.
+    std::vector<size_t> bucketBounds(1, 0);
+    size_t offset = 0;
+    for (size_t bucket=0; bucket<nBuckets; ++bucket) {
+        for (size_t block=0; block<nBlocks; ++block) {
+            size_t count = counts[block * nBuckets + bucket];
+            counts[block * nBuckets + bucket] = offset;
+            offset += count;
+        }
+        bucketBounds.push_back(offset);
+    }
+    assert(offset == n);
+
+    // Move values into their buckets in a temporary buffer, then back.
+    std::vector<Value> buffer(begin, end);
+    Value *tmp = &buffer[0];
+    for (size_t block=0; block<nBlocks; ++block) {
+        pool.submit(boost::bind(scatterTask<RandomAccessIterator, Value*, Compare>,
+                                begin + n * block / nBlocks, begin + n * (block+1) / nBlocks,
+                                boost::cref(splitters), compare, &counts[block * nBuckets], tmp));
+    }
+    pool.wait();
+    for (size_t block=0; block<nBlocks; ++block) {
+        size_t lo = n * block / nBlocks, hi = n * (block+1) / nBlocks;
+        pool.submit(boost::bind(copyTask<Value*, RandomAccessIterator>, tmp + lo, tmp + hi, begin + lo));
+    }
+    pool.wait();
+
+    // Sort the buckets.
+    for (size_t bucket=0; bucket<nBuckets; ++bucket) {
+        size_t lo = bucketBounds[bucket], hi = bucketBounds[bucket+1];
+        if (hi - lo > 1) {
+            pool.submit(boost::bind(quicksortTask<RandomAccessIterator, Compare>, boost::ref(pool), begin + lo, begin + hi,
+                                    compare, 2 * Private::log2(hi - lo)));
+        }
+    }
+    pool.wait();
+}
+
 } // namespace
 } // namespace
 
@@ -0,0 +1,324 @@
+// Hash table keyed by pointers, with optional lock striping. See PointerHashMap.
+#ifndef ROSE_PointerHashMap_H
+#define ROSE_PointerHashMap_H
+
+#include <boost/cstdint.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cassert>
+#include <deque>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace rose {
+
+/** Hash table whose keys are pointers.
+ *
+ *  This is a replacement for <code>std::map<Key,Value></code> when the keys are pointers (such as IR nodes) whose order is
+ *  irrelevant.  It has the parts of the std::map interface that are commonly used (find, insert, operator[], erase, size,
+ *  clear, and iteration), so code that uses a std::map can usually switch to this class by changing only type names.
+ *
+ *  The table is split into <code>2^StripeBits</code> independent stripes, each protected by its own mutex and chosen by some
+ *  bits of the key's hash.  Within a stripe, the key/value pairs are stored contiguously in insertion order and an
+ *  open-addressing index (linear probing, at most half full) maps keys to positions.  Compared to std::map this makes lookups
+ *  O(1) instead of O(log n), and each entry costs its key/value pair plus a few bytes of index instead of a separately
+ *  allocated tree node.
+ *
+ *  Thread safety: All member functions may be called concurrently.  Each one locks only the stripe that holds the key, so
+ *  threads that work on different keys seldom wait for one another.  References, pointers, and iterators to entries remain
+ *  valid when other entries are inserted (even concurrently), which allows the usual find-then-modify idiom as long as no two
+ *  threads modify the same key.  They're invalidated by @ref erase and @ref clear, and advancing an iterator is not safe while
+ *  another thread inserts or erases entries.  The null pointer cannot be used as a key.
+ *
+ *  Iteration order is unspecified and, since it depends on the key addresses, differs from run to run.  Code that prints the
+ *  entries or compares them with expected output should sort them by some other key first. */
+template<class Key, class Value, unsigned StripeBits = 0>
+class PointerHashMap {
+public:
+    typedef Key key_type;
+    typedef Value mapped_type;
+    typedef std::pair<Key, Value> value_type;
+    typedef size_t size_type;
+
+private:
+    static const size_t nStripes = size_t(1) << StripeBits;
+    static const size_t minIndexSize = 16;
+
+    struct Stripe {
+        mutable boost::mutex mutex;                     // protects the other members
+        std::deque<value_type> entries;                 // key/value pairs; a deque so insertion doesn't move them
+        std::vector<boost::uint32_t> index;             // zero, or one plus the position in entries; size is a power of two
+    };
+
+    Stripe stripes_[nStripes];
+
+    template<class MapPtr, class Reference, class Pointer>
+    class IteratorBase: public std::iterator<std::forward_iterator_tag, value_type, std::ptrdiff_t, Pointer, Reference> {
+        friend class PointerHashMap;
+        MapPtr map_;
+        size_t stripe_, position_;
+        Pointer entry_;                                 // cached so that dereferencing needn't touch the deque's block map
+
+        IteratorBase(MapPtr map, size_t stripe, size_t position)
+            : map_(map), stripe_(stripe), position_(position), entry_(NULL) {
+            settle();
+        }
+
+        // Moves forward to an entry that exists, or to the end.
+        void settle() {
+            while (stripe_ < nStripes && position_ >= map_->stripes_[stripe_].entries.size()) {
+                ++stripe_;
+                position_ = 0;
+            }
+            entry_ = stripe_ < nStripes ? &map_->stripes_[stripe_].entries[position_] : NULL;
+        }
+
+    public:
+        IteratorBase(): map_(NULL), stripe_(nStripes), position_(0), entry_(NULL) {}
+
+        template<class M2, class R2, class P2>
+        IteratorBase(const IteratorBase<M2, R2, P2> &other)
+            : map_(other.map_), stripe_(other.stripe_), position_(other.position_), entry_(other.entry_) {}
+
+        Reference operator*() const { return *entry_; }
+        Pointer operator->() const { return entry_; }
+        IteratorBase& operator++() { ++position_; settle(); return *this; }
+        IteratorBase operator++(int) { IteratorBase old = *this; ++*this; return old; }
+
+        template<class M2, class R2, class P2>
+        bool operator==(const IteratorBase<M2, R2, P2> &other) const {
+            return stripe_ == other.stripe_ && position_ == other.position_;
+        }
+        template<class M2, class R2, class P2>
+        bool operator!=(const IteratorBase<M2, R2, P2> &other) const {
+            return !(*this == other);
+        }
+
+        template<class M2, class R2, class P2> friend class IteratorBase;
+    };
+
+public:
+    /** Forward iterator over the key/value pairs. */
+    typedef IteratorBase<PointerHashMap*, value_type&, value_type*> iterator;
+
+    /** Forward iterator over the key/value pairs of a const map. */
+    typedef IteratorBase<const PointerHashMap*, const value_type&, const value_type*> const_iterator;
+
+    /** Constructs an empty map. */
+    PointerHashMap() {}
+
+    /** Copy constructor.
+     *
+     *  Each stripe of @p other is copied while it's locked. */
+    PointerHashMap(const PointerHashMap &other) {
+        copyFrom(other);
+    }
+
+    /** Constructs a map from a range of key/value pairs, such as those of a std::map. */
+    template<class InputIterator>
+    PointerHashMap(InputIterator first, InputIterator last) {
+        for (/*void*/; first != last; ++first)
+            insert(value_type(first->first, first->second));
+    }
+
+    /** Assignment operator. */
+    PointerHashMap& operator=(const PointerHashMap &other) {
+        if (this != &other) {
+            clear();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    /** Number of entries. */
+    size_t size() const {
+        size_t n = 0;
+        for (size_t i = 0; i < nStripes; ++i) {
+            boost::lock_guard<boost::mutex> lock(stripes_[i].mutex);
+            n += stripes_[i].entries.size();
+        }
+        return n;
+    }
+
+    /** True if the map has no entries. */
+    bool empty() const {
+        return 0 == size();
+    }
+
+    /** Removes all entries and releases their memory. */
+    void clear() {
+        for (size_t i = 0; i < nStripes; ++i) {
+            boost::lock_guard<boost::mutex> lock(stripes_[i].mutex);
+            std::deque<value_type>().swap(stripes_[i].entries);
+            std::vector<boost::uint32_t>().swap(stripes_[i].index);
+        }
+    }
+
+    /** Iterators for the entries.
+     * @{ */
+    iterator begin() { return iterator(this, 0, 0); }
+    iterator end() { return iterator(this, nStripes, 0); }
+    const_iterator begin() const { return const_iterator(this, 0, 0); }
+    const_iterator end() const { return const_iterator(this, nStripes, 0); }
+    /** @} */
+
+    /** Finds the entry for a key, or returns the end iterator.
+     * @{ */
+    iterator find(Key key) {
+        size_t h = hash(key), s = stripeOf(h);
+        boost::lock_guard<boost::mutex> lock(stripes_[s].mutex);
+        size_t slot = findSlot(stripes_[s], key, h);
+        return slot == NOT_FOUND ? end() : iteratorAt(s, stripes_[s].index[slot] - 1);
+    }
+    const_iterator find(Key key) const {
+        size_t h = hash(key), s = stripeOf(h);
+        boost::lock_guard<boost::mutex> lock(stripes_[s].mutex);
+        size_t slot = findSlot(stripes_[s], key, h);
+        return slot == NOT_FOUND ? end() : const_iterator(iteratorAt(s, stripes_[s].index[slot] - 1));
+    }
+    /** @} */
+
+    /** Number of entries with the specified key, zero or one. */
+    size_t count(Key key) const {
+        size_t h = hash(key), s = stripeOf(h);
+        boost::lock_guard<boost::mutex> lock(stripes_[s].mutex);
+        return findSlot(stripes_[s], key, h) == NOT_FOUND ? 0 : 1;
+    }
+
+    /** Inserts a key/value pair if the key isn't present.
+     *
+     *  Returns the entry for the key and whether it was inserted, like std::map::insert. An existing value is not changed. */
+    std::pair<iterator, bool> insert(const value_type &pair) {
+        assert(pair.first != NULL);
+        size_t h = hash(pair.first), s = stripeOf(h);
+        boost::lock_guard<boost::mutex> lock(stripes_[s].mutex);
+        Stripe &stripe = stripes_[s];
+        size_t slot = findSlot(stripe, pair.first, h);
+        if (slot != NOT_FOUND)
+            return std::make_pair(iteratorAt(s, stripe.index[slot] - 1), false);
+        return std::make_pair(iteratorAt(s, append(stripe, pair, h)), true);
+    }
+
+    /** Returns the value for a key, inserting a default-constructed value if the key isn't present. */
+    Value& operator[](Key key) {
+        return insert(value_type(key, Value())).first->second;
+    }
+
+    /** Removes the entry for a key. Returns the number of entries removed, zero or one. */
+    size_t erase(Key key) {
+        size_t h = hash(key), s = stripeOf(h);
+        boost::lock_guard<boost::mutex> lock(stripes_[s].mutex);
+        Stripe &stripe = stripes_[s];
+        size_t slot = findSlot(stripe, key, h);
+        if (slot == NOT_FOUND)
+            return 0;
+        size_t position = stripe.index[slot] - 1;
+        removeSlot(stripe, slot);
+
+        // Fill the hole in the entries with the last entry so they stay contiguous.
+        size_t last = stripe.entries.size() - 1;
+        if (position != last) {
+            size_t lastSlot = findSlot(stripe, stripe.entries[last].first, hash(stripe.entries[last].first));
+            assert(lastSlot != NOT_FOUND);
+            stripe.entries[position] = stripe.entries[last];
+            stripe.index[lastSlot] = position + 1;
+        }
+        stripe.entries.pop_back();
+        return 1;
+    }
+
+    /** Removes the entry at an iterator. */
+    void erase(iterator i) {
+        erase(i->first);
+    }
+
+private:
+    static const size_t NOT_FOUND = size_t(-1);
+
+    // Mixes all bits of the pointer (whose low bits are usually zero) into the hash.
+    static size_t hash(Key key) {
+        boost::uint64_t x = (boost::uint64_t)(size_t)key;
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        return (size_t)x;
+    }
+
+    // Stripe is chosen by the high bits so that it's independent of the low bits used for the slots.
+    static size_t stripeOf(size_t h) {
+        return 0 == StripeBits ? 0 : (h >> (8 * sizeof(size_t) - StripeBits)) & (nStripes - 1);
+    }
+
+    iterator iteratorAt(size_t stripe, size_t position) {
+        return iterator(this, stripe, position);
+    }
+
+    iterator iteratorAt(size_t stripe, size_t position) const {
+        return iterator(const_cast<PointerHashMap*>(this), stripe, position);
+    }
+
+    // Index slot holding key, or NOT_FOUND. The stripe must be locked.
+    static size_t findSlot(const Stripe &stripe, Key key, size_t h) {
+        if (stripe.index.empty())
+            return NOT_FOUND;
+        size_t mask = stripe.index.size() - 1;
+        for (size_t slot = h & mask; stripe.index[slot] != 0; slot = (slot + 1) & mask) {
+            if (stripe.entries[stripe.index[slot] - 1].first == key)
+                return slot;
+        }
+        return NOT_FOUND;
+    }
+
+    // Adds an entry whose key is not present and returns its position. The stripe must be locked.
+    static size_t append(Stripe &stripe, const value_type &pair, size_t h) {
+        if (2 * (stripe.entries.size() + 1) > stripe.index.size())
+            rehash(stripe, stripe.index.empty() ? minIndexSize : 2 * stripe.index.size());
+        size_t mask = stripe.index.size() - 1;
+        size_t slot = h & mask;
+        while (stripe.index[slot] != 0)
+            slot = (slot + 1) & mask;
+        stripe.entries.push_back(pair);
+        stripe.index[slot] = stripe.entries.size();
+        return stripe.entries.size() - 1;
+    }
+
+    // Rebuilds the index with the specified number of slots. The stripe must be locked.
+    static void rehash(Stripe &stripe, size_t nSlots) {
+        std::vector<boost::uint32_t>(nSlots, 0).swap(stripe.index);
+        size_t mask = nSlots - 1;
+        for (size_t i = 0; i < stripe.entries.size(); ++i) {
+            size_t slot = hash(stripe.entries[i].first) & mask;
+            while (stripe.index[slot] != 0)
+                slot = (slot + 1) & mask;
+            stripe.index[slot] = i + 1;
+        }
+    }
+
+    // Empties an index slot by shifting later slots of the same probe sequence back, so no tombstones are needed. The
+    // stripe must be locked.
+    static void removeSlot(Stripe &stripe, size_t hole) {
+        size_t mask = stripe.index.size() - 1;
+        for (size_t slot = (hole + 1) & mask; stripe.index[slot] != 0; slot = (slot + 1) & mask) {
+            size_t home = hash(stripe.entries[stripe.index[slot] - 1].first) & mask;
+            if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+                stripe.index[hole] = stripe.index[slot];
+                hole = slot;
+            }
+        }
+        stripe.index[hole] = 0;
+    }
+
+    void copyFrom(const PointerHashMap &other) {
+        for (size_t i = 0; i < nStripes; ++i) {
+            boost::lock_guard<boost::mutex> otherLock(other.stripes_[i].mutex);
+            boost::lock_guard<boost::mutex> lock(stripes_[i].mutex);
+            stripes_[i].entries = other.stripes_[i].entries;
+            stripes_[i].index = other.stripes_[i].index;
+        }
+    }
+};
+
+} // namespace
+
+#endif
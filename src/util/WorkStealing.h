@@ -0,0 +1,274 @@
+// Work-stealing thread pool. See WorkStealing::Pool.
+#ifndef ROSE_WorkStealing_H
+#define ROSE_WorkStealing_H
+
+#include <boost/exception_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <cassert>
+#include <deque>
+#include <vector>
+
+namespace rose {
+
+/** Running independent tasks on multiple threads.
+ *
+ *  This namespace contains a small work-stealing scheduler that's shared by the parts of ROSE that want to spread
+ *  independent units of work across threads.  Each thread owns a double-ended queue of tasks. A thread pushes and pops tasks
+ *  at the back of its own queue (last-in-first-out, which keeps recently generated work in cache), and when its queue is empty
+ *  it steals from the front of some other thread's queue (first-in-first-out, which tends to steal the largest pieces of
+ *  recursively divided work). */
+namespace WorkStealing {
+
+/** Number of threads to use when the user asks for zero threads.
+ *
+ *  Returns the number of hardware threads, or one if that can't be determined. */
+inline size_t
+defaultNThreads() {
+    size_t n = boost::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+/** Work-stealing pool of threads.
+ *
+ *  Tasks are submitted with @ref submit and executed by @ref wait, which borrows the calling thread as one of the workers and
+ *  does not return until all submitted tasks (including tasks submitted by other tasks while they run) have completed.  A
+ *  pool can be reused for any number of submit/wait cycles. The other worker threads are started by the first call to @ref
+ *  wait and sleep between calls until the pool is destroyed, so code that runs many small batches should keep one pool
+ *  rather than constructing a new one per batch.  For example, here's how to run one task per function:
+ *
+ * @code
+ *  WorkStealing::Pool pool(nThreads);
+ *  BOOST_FOREACH (SgAsmFunction *function, functions)
+ *      pool.submit(boost::bind(analyzeFunction, function));
+ *  pool.wait();
+ * @endcode
+ *
+ *  Tasks must not assume anything about which thread runs them or in what order they run.  If a task throws an exception
+ *  then the remaining tasks still run and the first exception is rethrown by @ref wait.
+ *
+ *  Thread safety: @ref submit may be called concurrently from any thread, including from within a running task. The other
+ *  methods should be called only by the thread that owns the pool. */
+class Pool {
+public:
+    /** A unit of work. */
+    typedef boost::function<void()> Task;
+
+private:
+    struct Queue {
+        boost::mutex mutex;                             // protects the task list
+        std::deque<Task> tasks;                         // owner pops from the back; thieves steal from the front
+    };
+
+    size_t nThreads_;                                   // total number of workers including the thread that calls wait()
+    std::vector<Queue*> queues_;                        // one per worker; pointers since mutexes are non-copyable
+    std::vector<boost::thread*> threads_;               // workers 1 through nThreads_-1, started by the first wait()
+    boost::thread_specific_ptr<size_t> workerId_;       // identifies the worker running on the current thread
+
+    boost::mutex mutex_;                                // protects all following data members
+    boost::condition_variable changed_;                 // signaled when tasks are submitted or all work finishes
+    size_t nOutstanding_;                               // tasks submitted but not yet completed
+    size_t nSubmitted_;                                 // total tasks ever submitted; used to detect missed wakeups
+    size_t nStolen_;                                    // number of tasks that ran on a thread other than their owner
+    size_t nextQueue_;                                  // round-robin queue for tasks submitted from non-worker threads
+    size_t nActive_;                                    // number of threads_ currently running tasks
+    bool running_;                                      // true while wait() is running tasks
+    bool shuttingDown_;                                 // true when the destructor wants threads_ to exit
+    boost::exception_ptr exception_;                    // first exception thrown by a task
+
+public:
+    /** Construct a pool.
+     *
+     *  The pool will use @p nThreads threads when @ref wait is called, including the calling thread. A value of zero means
+     *  use as many threads as there is hardware concurrency. */
+    explicit Pool(size_t nThreads)
+        : nThreads_(nThreads ? nThreads : defaultNThreads()), nOutstanding_(0), nSubmitted_(0), nStolen_(0), nextQueue_(0),
+          nActive_(0), running_(false), shuttingDown_(false) {
+        for (size_t i=0; i<nThreads_; ++i)
+            queues_.push_back(new Queue);
+    }
+
+    ~Pool() {
+        {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            shuttingDown_ = true;
+        }
+        changed_.notify_all();
+        for (size_t i=0; i<threads_.size(); ++i) {
+            threads_[i]->join();
+            delete threads_[i];
+        }
+        for (size_t i=0; i<queues_.size(); ++i)
+            delete queues_[i];
+    }
+
+private:
+    Pool(const Pool&);                                  // not copyable
+    Pool& operator=(const Pool&);
+
+public:
+    /** Number of worker threads. */
+    size_t nThreads() const { return nThreads_; }
+
+    /** Index of the worker running the calling task.
+     *
+     *  Returns a number less than @ref nThreads that identifies the worker on which the calling task is running, which is
+     *  useful for indexing per-worker resources such as cloned objects that are not thread safe.  Returns zero when called
+     *  from outside a task. */
+    size_t currentWorker() const {
+        return workerId_.get() ? *workerId_ : 0;
+    }
+
+    /** Number of tasks that were stolen from one worker by another since the pool was created. */
+    size_t nStolen() {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        return nStolen_;
+    }
+
+    /** Add a task to the pool.
+     *
+     *  When called from within a running task the new task is added to the current worker's own queue, otherwise tasks are
+     *  distributed among the queues round robin. */
+    void submit(const Task &task) {
+        size_t queueId = 0;
+        {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            ++nOutstanding_;
+            ++nSubmitted_;
+            queueId = workerId_.get() ? *workerId_ : nextQueue_++ % nThreads_;
+        }
+        {
+            boost::lock_guard<boost::mutex> lock(queues_[queueId]->mutex);
+            queues_[queueId]->tasks.push_back(task);
+        }
+        changed_.notify_all();
+    }
+
+    /** Run all tasks to completion.
+     *
+     *  Wakes the worker threads (starting them if this is the first call), runs tasks on them and the calling thread until no
+     *  tasks remain, and waits for the workers to go back to sleep.  Tasks never run outside a call to this method.  If any
+     *  task threw an exception then the first such exception is rethrown here after all other tasks complete. */
+    void wait() {
+        if (threads_.empty()) {
+            for (size_t i=1; i<nThreads_; ++i)
+                threads_.push_back(new boost::thread(Worker(this, i)));
+        }
+        {
+            boost::lock_guard<boost::mutex> lock(mutex_);
+            running_ = true;
+        }
+        changed_.notify_all();
+
+        work(0);
+
+        boost::exception_ptr e;
+        {
+            // No tasks remain, but some workers might still be on their way out of work(). Wait for them so none of them can
+            // pick up a task submitted before the next wait().
+            boost::unique_lock<boost::mutex> lock(mutex_);
+            running_ = false;
+            while (nActive_ > 0)
+                changed_.wait(lock);
+            e = exception_;
+            exception_ = boost::exception_ptr();
+        }
+        if (e)
+            boost::rethrow_exception(e);
+    }
+
+private:
+    // Obtain the next task for the specified worker, first from its own queue and then by stealing from others.
+    bool nextTask(size_t id, Task &task /*out*/) {
+        {
+            Queue *q = queues_[id];
+            boost::lock_guard<boost::mutex> lock(q->mutex);
+            if (!q->tasks.empty()) {
+                task = q->tasks.back();
+                q->tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t i=1; i<nThreads_; ++i) {
+            Queue *victim = queues_[(id + i) % nThreads_];
+            boost::lock_guard<boost::mutex> lock(victim->mutex);
+            if (!victim->tasks.empty()) {
+                task = victim->tasks.front();
+                victim->tasks.pop_front();
+                boost::lock_guard<boost::mutex> poolLock(mutex_);
+                ++nStolen_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Runs tasks until none remain.
+    void work(size_t id) {
+        workerId_.reset(new size_t(id));
+        while (true) {
+            size_t seen = 0;
+            {
+                boost::lock_guard<boost::mutex> lock(mutex_);
+                if (0 == nOutstanding_)
+                    break;
+                seen = nSubmitted_;
+            }
+
+            Task task;
+            if (nextTask(id, task)) {
+                try {
+                    task();
+                } catch (...) {
+                    boost::lock_guard<boost::mutex> lock(mutex_);
+                    if (!exception_)
+                        exception_ = boost::current_exception();
+                }
+                boost::lock_guard<boost::mutex> lock(mutex_);
+                assert(nOutstanding_ > 0);
+                if (0 == --nOutstanding_)
+                    changed_.notify_all();
+            } else {
+                // Nothing to run. Sleep until something new is submitted or everything finishes. Comparing the submission
+                // count avoids sleeping through a task that was submitted after we scanned the queues.
+                boost::unique_lock<boost::mutex> lock(mutex_);
+                while (nOutstanding_ > 0 && nSubmitted_ == seen)
+                    changed_.wait(lock);
+            }
+        }
+        workerId_.reset();
+    }
+
+    // Main loop for each of threads_. Sleeps until wait() has tasks to run or the pool is destroyed.
+    void serve(size_t id) {
+        while (true) {
+            {
+                boost::unique_lock<boost::mutex> lock(mutex_);
+                while (!shuttingDown_ && !(running_ && nOutstanding_ > 0))
+                    changed_.wait(lock);
+                if (shuttingDown_)
+                    return;
+                ++nActive_;
+            }
+            work(id);
+            {
+                boost::lock_guard<boost::mutex> lock(mutex_);
+                assert(nActive_ > 0);
+                --nActive_;
+            }
+            changed_.notify_all();
+        }
+    }
+
+    struct Worker {
+        Pool *pool;
+        size_t id;
+        Worker(Pool *pool, size_t id): pool(pool), id(id) {}
+        void operator()() { pool->serve(id); }
+    };
+};
+
+} // namespace
+} // namespace
+
+#endif
@@ -0,0 +1,46 @@
+// Declarations shared by parallelMerge_a.C and parallelMerge_b.C, which the AST merge must share between the two files.
+#ifndef PARALLEL_MERGE_SHARED_H
+#define PARALLEL_MERGE_SHARED_H
+
+typedef unsigned long Counter;
+
+enum Color { RED, GREEN, BLUE };
+
+struct Point
+   {
+     int x, y;
+     Point() : x(0), y(0) {}
+     Point(int x, int y) : x(x), y(y) {}
+     int manhattan() const { return (x < 0 ? -x : x) + (y < 0 ? -y : y); }
+   };
+
+class Shape
+   {
+     public:
+          virtual ~Shape() {}
+          virtual double area() const = 0;
+          Color color;
+   };
+
+template <class T>
+class Stack
+   {
+     public:
+          Stack() : n(0) {}
+          void push(const T &x) { if (n < 16) items[n++] = x; }
+          T pop() { return items[--n]; }
+          bool empty() const { return n == 0; }
+     private:
+          T items[16];
+          int n;
+   };
+
+namespace geometry
+   {
+     double distance(const Point &a, const Point &b);
+     extern Counter nDistances;
+   }
+
+int sharedFunction(int);
+
+#endif
@@ -0,0 +1,6 @@
+// Header included only by input_parallel_a.C
+struct PointA {
+    int x, y;
+};
+
+int lengthA(const PointA&);
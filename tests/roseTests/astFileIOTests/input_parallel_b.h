@@ -0,0 +1,12 @@
+// Header included only by input_parallel_b.C. It is longer than input_parallel_a.h so that the line numbers of the two
+// headers differ.
+
+namespace B {
+
+struct PointB {
+    double x, y, z;
+};
+
+double lengthB(const PointB&);
+
+}